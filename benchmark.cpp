@@ -0,0 +1,869 @@
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "rs_decoder.h"
+#include "rs_encoder.h"
+#include "rs_bitsliced.h"
+#include "rs_gmd.h"
+#include "rs_codec.h"
+#include "rs_interleave.h"
+#include "rs_constant_time.h"
+
+// Encoder and decoder benchmarks
+// Build: g++ -std=c++17 -O2 -march=native -pthread benchmark.cpp -o benchmark
+// Usage: benchmark [all|stages|syndromes|key-equation|encoder|bitsliced|gmd|codec|shortened|interleave|constant-time|transform] [frames] [rounds]
+//                  [--output FILE] [--baseline FILE] [--tolerance PERCENT]
+// Every measurement is also recorded as a "name,value,unit" line: --output writes them as CSV,
+// and --baseline compares them with a stored CSV file and fails if one got slower by more than
+// the tolerance (ns are lower-is-better, MB/s higher-is-better).
+
+struct BenchmarkResult {
+    std::string name;
+    double value;
+    std::string unit;
+};
+std::vector<BenchmarkResult> results;
+
+void record(const std::string& name, double value, const std::string& unit) {
+    results.push_back({name, value, unit});
+}
+
+// Write the results as CSV
+bool write_results(const char* path) {
+    FILE* file = fopen(path, "w");
+    if(file == nullptr) return false;
+    fprintf(file, "name,value,unit\n");
+    for(const auto& result : results) fprintf(file, "%s,%.3f,%s\n", result.name.c_str(), result.value, result.unit.c_str());
+    fclose(file);
+    return true;
+}
+
+// Compare the results with a baseline CSV file, returns the number of regressions (-1 if unreadable)
+int compare_baseline(const char* path, double tolerance) {
+    FILE* file = fopen(path, "r");
+    if(file == nullptr) return -1;
+    std::map<std::string, double> baseline;
+    char line[256];
+    while(fgets(line, sizeof(line), file)) {
+        char name[200];
+        double value;
+        if(sscanf(line, "%199[^,],%lf", name, &value) == 2) baseline[name] = value;
+    }
+    fclose(file);
+    int regressions = 0;
+    printf("Comparison with %s (tolerance %.0f%%)\n", path, tolerance);
+    printf("%-44s %12s %12s %9s\n", "name", "baseline", "current", "change");
+    for(const auto& result : results) {
+        auto it = baseline.find(result.name);
+        if(it == baseline.end() || it->second <= 0) continue;
+        // Positive change = faster
+        bool lower_is_better = result.unit == "ns";
+        double change = lower_is_better ? it->second / result.value - 1 : result.value / it->second - 1;
+        bool regression = change * 100 < -tolerance;
+        regressions += regression;
+        printf("%-44s %12.1f %12.1f %+8.1f%%%s\n", result.name.c_str(), it->second, result.value, change * 100,
+               regression ? "  REGRESSION" : "");
+    }
+    return regressions;
+}
+
+// Encode a random message
+void make_random_codeword(uint8_t* codeword, std::mt19937& gen) {
+    static const ReedSolomonEncoder encoder;
+    std::uniform_int_distribution<> value(0, 63);
+    uint8_t message[42];
+    for(int i = 0; i < 42; i++) message[i] = value(gen);
+    encoder.encodeSystematic(message, codeword);
+}
+
+// Fill a batch with random codewords carrying the given number of errors and erasures
+void make_corrupted_batch(CodewordBatch& batch, int num_errors, int num_erasures, std::mt19937& gen) {
+    std::uniform_int_distribution<> value(1, 63);
+    std::vector<int> positions(63);
+    for(size_t f = 0; f < batch.count; f++) {
+        uint8_t* frame = batch.frame(f);
+        make_random_codeword(frame, gen);
+        for(int i = 0; i < 63; i++) positions[i] = i;
+        std::shuffle(positions.begin(), positions.end(), gen);
+        batch.erasure_masks[f] = 0;
+        for(int i = 0; i < num_erasures; i++) {
+            batch.erasure_masks[f] |= 1ULL << positions[i];
+            frame[positions[i]] ^= value(gen);
+        }
+        for(int i = num_erasures; i < num_erasures + num_errors; i++) {
+            frame[positions[i]] ^= value(gen);
+        }
+    }
+}
+
+// Average time per frame of decode_batch in nanoseconds (best of several rounds)
+double time_decode_batch(ReedSolomonDecoder& decoder, CodewordBatch& batch, int rounds) {
+    double best = 1e30;
+    for(int r = 0; r < rounds; r++) {
+        auto start = std::chrono::steady_clock::now();
+        decoder.decode_batch(batch);
+        auto end = std::chrono::steady_clock::now();
+        double ns = std::chrono::duration<double, std::nano>(end - start).count() / batch.count;
+        if(ns < best) best = ns;
+    }
+    return best;
+}
+
+// Time every decoder stage on its own (friend of ReedSolomonDecoder)
+// The frames are decoded once to keep the input of every stage in its own workspace, then each
+// stage runs over all frames in a tight loop. Every frame of a mix is corrupted, so every stage
+// runs on every frame; times are ns per frame.
+class DecoderStageBenchmark {
+    public:
+        static void run(size_t frames, int rounds) {
+            const int mixes[][2] = {{1, 0}, {2, 0}, {4, 0}, {0, 4}, {4, 4}, {6, 0}, {8, 0}, {10, 0},
+                                    {0, 10}, {5, 11}, {0, 21}};
+            const char* stages[] = {"syndromes", "erasure-locator", "correct-erasures", "euclidean",
+                                    "berlekamp-massey", "correct-errors", "merge", "decode_frame"};
+            // The workspaces hold about 3 KB each
+            frames = std::min<size_t>(frames, 4096);
+            std::mt19937 gen(2025);
+            ReedSolomonDecoder decoder;
+            CodewordBatch batch(frames);
+            std::vector<DecoderWorkspace> ws(frames);
+            std::vector<uint8_t> received(frames * CodewordBatch::stride);
+            std::vector<char> correctable(frames);
+
+            printf("Decoder stages (ns per frame, %zu frames)\n", frames);
+            printf("%7s %9s", "errors", "erasures");
+            for(const char* stage : stages) printf(" %16s", stage);
+            printf("\n");
+            for(const auto& mix : mixes) {
+                make_corrupted_batch(batch, mix[0], mix[1], gen);
+                // Received words with the erased symbols set to 0, as decode_frame sees them
+                for(size_t f = 0; f < frames; f++) {
+                    for(int i = 0; i < 63; i++) {
+                        received[f * CodewordBatch::stride + i] = ((batch.erasure_masks[f] >> i) & 1) ? 0 : batch.frame(f)[i];
+                    }
+                }
+                double ns[8];
+                ns[0] = per_frame(frames, rounds, [&](size_t f) {
+                    decoder.calculateSyndromes(&received[f * CodewordBatch::stride], ws[f].syndromes);
+                });
+                ns[1] = per_frame(frames, rounds, [&](size_t f) {
+                    decoder.calculateErasureLocator(batch.erasure_masks[f], ws[f].erasure_locator);
+                    decoder.calculateForneySyndromes(ws[f]);
+                });
+                // Erasure-only path (it stops at the Forney syndromes on frames with errors)
+                ns[2] = per_frame(frames, rounds, [&](size_t f) { decoder.correctErasures(batch.erasure_masks[f], ws[f]); });
+                // Berlekamp-Massey first, so the workspaces keep the Euclidean result
+                ns[4] = per_frame(frames, rounds, [&](size_t f) { decoder.berlekampMasseyAlgorithm(ws[f]); });
+                ns[3] = per_frame(frames, rounds, [&](size_t f) { decoder.euclideanAlgorithm(ws[f]); });
+                ns[5] = per_frame(frames, rounds, [&](size_t f) { correctable[f] = decoder.correctErrors(ws[f]); });
+                // codeword = received + error (applied twice per two rounds, the timing does not care)
+                ns[6] = per_frame(frames, rounds, [&](size_t f) {
+                    if(!correctable[f]) return;
+                    uint8_t* codeword = batch.corrected_frame(f);
+                    for(int e = 0; e < ws[f].num_errors; e++) {
+                        codeword[ws[f].error_positions[e]] ^= ws[f].error_values[e].get_value();
+                    }
+                });
+                DecoderWorkspace frame_ws;
+                ns[7] = per_frame(frames, rounds, [&](size_t f) {
+                    batch.status[f] = decoder.decode_frame(batch.frame(f), batch.erasure_masks[f], batch.corrected_frame(f), frame_ws);
+                });
+                printf("%7d %9d", mix[0], mix[1]);
+                std::string mix_name = "e" + std::to_string(mix[0]) + "r" + std::to_string(mix[1]);
+                for(int stage = 0; stage < 8; stage++) {
+                    printf(" %16.1f", ns[stage]);
+                    record("stages/" + mix_name + "/" + stages[stage], ns[stage], "ns");
+                }
+                printf("\n");
+            }
+        }
+
+        // The 63-point transform against the direct loops: syndromes (Horner's rule per syndrome,
+        // the transform, the table engine) and the root search of correctErrors at each locator
+        // degree (Chien search against transformSearch, on the same key equation results)
+        static void run_transform(size_t frames, int rounds) {
+            const int mixes[][2] = {{2, 0}, {4, 0}, {6, 0}, {8, 0}, {10, 0}, {4, 8}, {5, 11}, {16, 0}};
+            frames = std::min<size_t>(frames, 4096);
+            std::mt19937 gen(2025);
+            ReedSolomonDecoder decoder;
+            CodewordBatch batch(frames);
+            std::vector<DecoderWorkspace> ws(frames);
+            std::vector<uint8_t> received(frames * CodewordBatch::stride);
+            std::vector<int> degree(frames);
+            std::vector<size_t> searched;
+            alignas(32) uint8_t values[32];
+            uint8_t sink = 0;
+
+            make_corrupted_batch(batch, 10, 0, gen);
+            double direct_ns = per_frame(frames, rounds, [&](size_t f) {
+                const uint8_t* r = batch.frame(f);
+                for(int j = 0; j < 21; j++) {
+                    GF64 value(r[62]), alpha(pow_table[j + 1]);
+                    for(int i = 61; i >= 0; i--) value = value * alpha + GF64(r[i]);
+                    values[j] = value.get_value();
+                }
+                sink ^= values[20];
+            });
+            double transform_ns = per_frame(frames, rounds, [&](size_t f) {
+                GF64Transform::syndromes(batch.frame(f), values);
+                sink ^= values[20];
+            });
+            double table_ns = per_frame(frames, rounds, [&](size_t f) {
+                SyndromeTableEngine::instance().compute(batch.frame(f), values);
+                sink ^= values[20];
+            });
+            printf("Syndromes (ns per frame, %zu frames)\n", frames);
+            printf("%12s %12s %12s %18s %18s\n", "direct", "transform", "table", "direct products", "transform products");
+            printf("%12.1f %12.1f %12.1f %18d %18d\n", direct_ns, transform_ns, table_ns, 21 * 62, GF64Transform::products);
+            record("transform/syndromes/direct", direct_ns, "ns");
+            record("transform/syndromes/transform", transform_ns, "ns");
+            record("transform/syndromes/table", table_ns, "ns");
+
+            printf("Root search of correctErrors (ns per frame, %zu frames)\n", frames);
+            printf("%7s %9s %7s %12s %12s %8s %15s %18s %6s\n", "errors", "erasures", "degree", "chien", "transform",
+                   "speedup", "chien products", "transform products", "same");
+            for(const auto& mix : mixes) {
+                make_corrupted_batch(batch, mix[0], mix[1], gen);
+                for(size_t f = 0; f < frames; f++) {
+                    uint8_t* r = &received[f * CodewordBatch::stride];
+                    for(int i = 0; i < 63; i++) r[i] = ((batch.erasure_masks[f] >> i) & 1) ? 0 : batch.frame(f)[i];
+                    decoder.calculateSyndromes(r, ws[f].syndromes);
+                    decoder.calculateErasureLocator(batch.erasure_masks[f], ws[f].erasure_locator);
+                    decoder.calculateForneySyndromes(ws[f]);
+                    decoder.berlekampMasseyAlgorithm(ws[f]);
+                    degree[f] = ws[f].locator.get_degree();
+                }
+                // Only the frames that pass the checks of correctErrors reach the search
+                searched.clear();
+                long degree_sum = 0;
+                for(size_t f = 0; f < frames; f++) {
+                    if(ws[f].locator.get_coefficient(0).get_value() == 0 || ws[f].evaluator.get_degree() >= degree[f]) continue;
+                    searched.push_back(f);
+                    degree_sum += degree[f];
+                }
+                size_t count = searched.size();
+                if(count == 0) continue;
+                std::vector<char> chien_ok(frames), transform_ok(frames);
+                double chien_ns = per_frame(count, rounds, [&](size_t s) {
+                    size_t f = searched[s];
+                    ws[f].num_errors = 0;
+                    chien_ok[f] = decoder.chienSearch(ws[f], degree[f], 42);
+                });
+                std::vector<uint8_t> chien_result(frames * CodewordBatch::stride);
+                for(size_t f : searched) {
+                    uint8_t* e = &chien_result[f * CodewordBatch::stride];
+                    for(int i = 0; chien_ok[f] && i < ws[f].num_errors; i++) e[ws[f].error_positions[i]] = ws[f].error_values[i].get_value();
+                }
+                double transform_ns = per_frame(count, rounds, [&](size_t s) {
+                    size_t f = searched[s];
+                    ws[f].num_errors = 0;
+                    transform_ok[f] = decoder.transformSearch(ws[f], degree[f], 42);
+                });
+                bool same = true;
+                for(size_t f : searched) {
+                    uint8_t e[64] = {0};
+                    for(int i = 0; transform_ok[f] && i < ws[f].num_errors; i++) e[ws[f].error_positions[i]] = ws[f].error_values[i].get_value();
+                    same = same && chien_ok[f] == transform_ok[f] && memcmp(e, &chien_result[f * CodewordBatch::stride], 63) == 0;
+                }
+                // Products of the searches alone (the Forney evaluations at the roots come on top):
+                // deg(Lambda) register steps per position, and evaluate() at most 6 per coefficient
+                double mean_degree = (double)degree_sum / count;
+                printf("%7d %9d %7.1f %12.1f %12.1f %7.2fx %15.0f %18.0f %6s\n", mix[0], mix[1], mean_degree, chien_ns,
+                       transform_ns, chien_ns / transform_ns, 63 * mean_degree, 6 * (mean_degree + 1) + 7 * 10,
+                       same ? "yes" : "NO");
+                std::string mix_name = "e" + std::to_string(mix[0]) + "r" + std::to_string(mix[1]);
+                record("transform/" + mix_name + "/chien", chien_ns, "ns");
+                record("transform/" + mix_name + "/transform", transform_ns, "ns");
+            }
+            if(sink == 0xFF) printf("\n");
+        }
+
+    private:
+        // Best time per frame in nanoseconds of calling function(f) for every frame
+        template<typename Function>
+        static double per_frame(size_t frames, int rounds, Function function) {
+            double best = 1e30;
+            for(int r = 0; r < rounds; r++) {
+                auto start = std::chrono::steady_clock::now();
+                for(size_t f = 0; f < frames; f++) function(f);
+                auto end = std::chrono::steady_clock::now();
+                best = std::min(best, std::chrono::duration<double, std::nano>(end - start).count() / frames);
+            }
+            return best;
+        }
+};
+
+// Compare the Euclidean and Berlekamp-Massey key equation solvers across error/erasure mixes
+void bench_key_equation(size_t frames, int rounds) {
+    const int mixes[][2] = {{1, 0}, {2, 0}, {3, 0}, {4, 0}, {0, 4}, {2, 4}, {4, 4},
+                            {6, 0}, {8, 0}, {10, 0}, {0, 10}, {5, 11}, {0, 21}};
+    std::mt19937 gen(2025);
+    ReedSolomonDecoder euclid(KEY_EQUATION_EUCLIDEAN), bm(KEY_EQUATION_BERLEKAMP_MASSEY);
+    CodewordBatch batch(frames);
+    std::vector<uint8_t> corrected(frames * CodewordBatch::stride);
+
+    printf("Key equation solvers (ns per decoded frame, %zu frames)\n", frames);
+    printf("%7s %9s %12s %12s %8s %6s\n", "errors", "erasures", "euclidean", "berlekamp", "speedup", "same");
+    for(const auto& mix : mixes) {
+        make_corrupted_batch(batch, mix[0], mix[1], gen);
+        double euclid_ns = time_decode_batch(euclid, batch, rounds);
+        std::copy(batch.corrected, batch.corrected + frames * CodewordBatch::stride, corrected.begin());
+        std::vector<uint8_t> euclid_status(batch.status, batch.status + frames);
+        double bm_ns = time_decode_batch(bm, batch, rounds);
+        // Both solvers must produce the same decoded frames
+        bool same = std::equal(corrected.begin(), corrected.end(), batch.corrected) &&
+                    std::equal(euclid_status.begin(), euclid_status.end(), batch.status);
+        printf("%7d %9d %12.1f %12.1f %7.2fx %6s\n", mix[0], mix[1], euclid_ns, bm_ns,
+               euclid_ns / bm_ns, same ? "yes" : "NO");
+        std::string mix_name = "e" + std::to_string(mix[0]) + "r" + std::to_string(mix[1]);
+        record("key-equation/" + mix_name + "/euclidean", euclid_ns, "ns");
+        record("key-equation/" + mix_name + "/berlekamp-massey", bm_ns, "ns");
+    }
+}
+
+// Best time of several rounds in seconds
+template<typename Function>
+double best_time(int rounds, Function function) {
+    double best = 1e30;
+    for(int r = 0; r < rounds; r++) {
+        auto start = std::chrono::steady_clock::now();
+        function();
+        auto end = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double>(end - start).count());
+    }
+    return best;
+}
+
+// Encoder throughput in MB/s of payload (42 symbols of 6 bits = 31.5 bytes per message)
+void bench_encoder(size_t messages, int rounds) {
+    const double payload_mb = messages * 42 * 6 / 8.0 / 1e6;
+    std::mt19937 gen(2025);
+    std::uniform_int_distribution<> value(0, 63);
+    std::vector<uint8_t> message_data(messages * 42), codewords(messages * 64), reference(messages * 64);
+    for(auto& symbol : message_data) symbol = value(gen);
+    ReedSolomonEncoder encoder;
+    const BatchEncoder& batch_encoder = BatchEncoder::instance();
+    int cores = std::max(1u, std::thread::hardware_concurrency());
+
+    printf("Encoder throughput (MB/s of payload, %zu messages)\n", messages);
+    // Polynomial multiplication (non-systematic), one message at a time through std::vector
+    std::vector<GF64> message(42);
+    double seconds = best_time(rounds, [&]() {
+        for(size_t f = 0; f < messages; f++) {
+            for(int i = 0; i < 42; i++) message[i] = GF64(message_data[f * 42 + i]);
+            std::vector<GF64> codeword = encoder.encode(message);
+            codewords[f * 64] = codeword[0].get_value();
+        }
+    });
+    printf("%-28s %10.1f\n", "encode (polynomial)", payload_mb / seconds);
+    record("encoder/encode", payload_mb / seconds, "MB/s");
+    // Shift register, one message at a time
+    seconds = best_time(rounds, [&]() {
+        for(size_t f = 0; f < messages; f++) encoder.encodeSystematic(&message_data[f * 42], &reference[f * 64]);
+    });
+    printf("%-28s %10.1f\n", "encodeSystematic (LFSR)", payload_mb / seconds);
+    record("encoder/encodeSystematic", payload_mb / seconds, "MB/s");
+    // Codeword check by polynomial division, one codeword at a time through std::vector
+    std::vector<GF64> codeword(63);
+    bool all_valid = true;
+    seconds = best_time(rounds, [&]() {
+        for(size_t f = 0; f < messages; f++) {
+            for(int i = 0; i < 63; i++) codeword[i] = GF64(reference[f * 64 + i]);
+            all_valid &= verify_codeword(codeword);
+        }
+    });
+    printf("%-28s %10.1f%s\n", "verify_codeword", payload_mb / seconds, all_valid ? "" : " (INVALID)");
+    record("encoder/verify_codeword", payload_mb / seconds, "MB/s");
+    // Table-driven batch encoder on one core and on all cores
+    for(int threads : {1, cores}) {
+        seconds = best_time(rounds, [&]() {
+            batch_encoder.encode_batch(message_data.data(), messages, codewords.data(), 42, 64, threads);
+        });
+        bool same = true;
+        for(size_t f = 0; f < messages; f++) same &= memcmp(&codewords[f * 64], &reference[f * 64], 63) == 0;
+        char name[64];
+        snprintf(name, sizeof(name), "BatchEncoder (%d thread%s)", threads, threads > 1 ? "s" : "");
+        printf("%-28s %10.1f%s\n", name, payload_mb / seconds, same ? "" : " (MISMATCH)");
+        record("encoder/BatchEncoder/threads-" + std::to_string(threads), payload_mb / seconds, "MB/s");
+        if(cores == 1) break;
+    }
+}
+
+// Syndrome engines (ns per frame): the direct sum over pow_table, the split-nibble engine and the
+// position x value table engine with every instruction set this build supports
+void bench_syndromes(size_t frames, int rounds) {
+    std::mt19937 gen(2025);
+    std::uniform_int_distribution<> value(0, 63);
+    std::vector<uint8_t> received(frames * 64), syndromes(frames * 32), reference(frames * 32);
+    for(auto& symbol : received) symbol = value(gen);
+    static const SyndromeEngine nibble_engine;
+    const SyndromeTableEngine& table_engine = SyndromeTableEngine::instance();
+
+    printf("Syndromes (ns per frame, %zu frames)\n", frames);
+    auto run = [&](const char* name, auto compute) {
+        double ns = best_time(rounds, [&]() {
+            for(size_t f = 0; f < frames; f++) compute(&received[f * 64], &syndromes[f * 32]);
+        }) * 1e9 / frames;
+        bool same = syndromes == reference;
+        printf("%-28s %10.1f%s\n", name, ns, same ? "" : " (MISMATCH)");
+        record(std::string("syndromes/") + name, ns, "ns");
+    };
+    // S_j = sum(r_i * a^(i*j)) with one table multiply per (position, syndrome)
+    auto direct = [](const uint8_t* r, uint8_t* S) {
+        for(int j = 0; j < 32; j++) S[j] = 0;
+        for(int i = 0; i < 63; i++) {
+            for(int j = 0; j < 21; j++) S[j] ^= mul_table[r[i]][pow_table[(i * (j + 1)) % 63]];
+        }
+    };
+    for(size_t f = 0; f < frames; f++) direct(&received[f * 64], &reference[f * 32]);
+    run("direct", direct);
+    run("nibble-scalar", [&](const uint8_t* r, uint8_t* S) { nibble_engine.compute_scalar(r, S); });
+#if defined(__SSSE3__)
+    run("nibble-ssse3", [&](const uint8_t* r, uint8_t* S) { nibble_engine.compute_ssse3(r, S); });
+#endif
+#if defined(__AVX2__)
+    run("nibble-avx2", [&](const uint8_t* r, uint8_t* S) { nibble_engine.compute_avx2(r, S); });
+#endif
+    run("table-scalar", [&](const uint8_t* r, uint8_t* S) { table_engine.compute_scalar(r, S); });
+#if defined(__SSE2__)
+    run("table-sse2", [&](const uint8_t* r, uint8_t* S) { table_engine.compute_sse2(r, S); });
+#endif
+#if defined(__AVX2__)
+    run("table-avx2", [&](const uint8_t* r, uint8_t* S) { table_engine.compute_avx2(r, S); });
+#endif
+}
+
+// GMD decoding against hard decoding and against running the GMD trials as separate decodes
+// Every error gets a low reliability with probability 3/4, the other symbols a high one with a
+// small overlap, so the least reliable symbols are mostly, but not always, the errors.
+void bench_gmd(size_t frames, int rounds) {
+    const int mixes[] = {4, 10, 12, 14, 16};
+    std::mt19937 gen(2025);
+    std::uniform_real_distribution<float> low(0, 0.5f), high(0.4f, 1);
+    std::uniform_int_distribution<> value(1, 63);
+    ReedSolomonDecoder decoder;
+    GMDDecoder gmd(decoder);
+    DecoderWorkspace ws;
+    CodewordBatch batch(frames);
+    std::vector<uint8_t> sent(frames * CodewordBatch::stride);
+    std::vector<float> reliability(frames * 63);
+    std::vector<int> positions(63), order(63);
+
+    printf("GMD decoding (ns per frame, %zu frames)\n", frames);
+    printf("%7s %10s %10s %10s %9s %9s %8s\n", "errors", "hard", "gmd", "trials", "hard ok%", "gmd ok%", "trials");
+    for(int num_errors : mixes) {
+        make_corrupted_batch(batch, 0, 0, gen);
+        std::copy(batch.symbols, batch.symbols + frames * CodewordBatch::stride, sent.begin());
+        for(size_t f = 0; f < frames; f++) {
+            float* r = &reliability[f * 63];
+            for(int i = 0; i < 63; i++) r[i] = high(gen);
+            for(int i = 0; i < 63; i++) positions[i] = i;
+            std::shuffle(positions.begin(), positions.end(), gen);
+            for(int i = 0; i < num_errors; i++) {
+                batch.frame(f)[positions[i]] ^= value(gen);
+                if(gen() % 4 != 0) r[positions[i]] = low(gen);
+            }
+        }
+        double hard_ns = best_time(rounds, [&]() {
+            for(size_t f = 0; f < frames; f++) {
+                batch.status[f] = decoder.decode_frame(batch.frame(f), 0, batch.corrected_frame(f), ws);
+            }
+        }) * 1e9 / frames;
+        long hard_ok = 0, gmd_ok = 0, total_trials = 0;
+        for(size_t f = 0; f < frames; f++) hard_ok += memcmp(batch.corrected_frame(f), &sent[f * CodewordBatch::stride], 63) == 0;
+        double gmd_ns = best_time(rounds, [&]() {
+            total_trials = 0;
+            for(size_t f = 0; f < frames; f++) {
+                int trials;
+                batch.status[f] = gmd.decode(batch.frame(f), &reliability[f * 63], 0, batch.corrected_frame(f), &trials);
+                total_trials += trials;
+            }
+        }) * 1e9 / frames;
+        for(size_t f = 0; f < frames; f++) gmd_ok += memcmp(batch.corrected_frame(f), &sent[f * CodewordBatch::stride], 63) == 0;
+        // The same trials as independent decodes from scratch
+        double trials_ns = best_time(rounds, [&]() {
+            for(size_t f = 0; f < frames; f++) {
+                const float* r = &reliability[f * 63];
+                uint64_t mask = 0;
+                for(int erased = 0; erased <= 20; erased += 2) {
+                    if(erased == 2) {
+                        for(int i = 0; i < 63; i++) order[i] = i;
+                        std::partial_sort(order.begin(), order.begin() + 20, order.end(), [&](int a, int b) {
+                            return r[a] < r[b] || (r[a] == r[b] && a < b);
+                        });
+                    }
+                    if(erased > 0) mask |= (1ULL << order[erased - 2]) | (1ULL << order[erased - 1]);
+                    DecodeStatus status = decoder.decode_frame(batch.frame(f), mask, batch.corrected_frame(f), ws);
+                    if(status == DECODE_OK || status == DECODE_CORRECTED) break;
+                }
+            }
+        }) * 1e9 / frames;
+        printf("%7d %10.1f %10.1f %10.1f %8.2f%% %8.2f%% %8.2f\n", num_errors, hard_ns, gmd_ns, trials_ns,
+               100.0 * hard_ok / frames, 100.0 * gmd_ok / frames, (double)total_trials / frames);
+        std::string mix_name = "e" + std::to_string(num_errors);
+        record("gmd/" + mix_name + "/hard", hard_ns, "ns");
+        record("gmd/" + mix_name + "/gmd", gmd_ns, "ns");
+        record("gmd/" + mix_name + "/separate-trials", trials_ns, "ns");
+    }
+}
+
+// Compare the frame-by-frame batch decoder with the bit-sliced one (64 frames per group)
+// A mix gives the share of corrupted frames and their errors/erasures, the other frames are clean
+void bench_bitsliced(size_t frames, int rounds) {
+    const int mixes[][3] = {{0, 0, 0}, {1, 1, 0}, {5, 1, 0}, {5, 10, 0}, {20, 2, 0}, {100, 1, 0}, {100, 4, 4}, {100, 10, 0}};
+    std::mt19937 gen(2025);
+    ReedSolomonDecoder decoder;
+    std::unique_ptr<BitslicedDecoder> bitsliced(new BitslicedDecoder());
+    CodewordBatch batch(frames);
+    std::vector<uint8_t> corrected(frames * CodewordBatch::stride), status(frames);
+    std::uniform_int_distribution<> percent(0, 99);
+
+    printf("Bit-sliced decoder (ns per frame, %zu frames)\n", frames);
+    printf("%9s %7s %9s %12s %12s %8s %6s\n", "corrupt%", "errors", "erasures", "scalar", "bitsliced", "speedup", "same");
+    for(const auto& mix : mixes) {
+        make_corrupted_batch(batch, mix[1], mix[2], gen);
+        // Restore the clean frames by decoding them once
+        decoder.decode_batch(batch);
+        for(size_t f = 0; f < frames; f++) {
+            if(percent(gen) < mix[0]) continue;
+            std::copy(batch.corrected_frame(f), batch.corrected_frame(f) + 63, batch.frame(f));
+            batch.erasure_masks[f] = 0;
+        }
+        double scalar_ns = time_decode_batch(decoder, batch, rounds);
+        std::copy(batch.corrected, batch.corrected + frames * CodewordBatch::stride, corrected.begin());
+        std::copy(batch.status, batch.status + frames, status.begin());
+        double bitsliced_ns = best_time(rounds, [&]() { bitsliced->decode_batch(batch); }) * 1e9 / frames;
+        bool same = std::equal(corrected.begin(), corrected.end(), batch.corrected) &&
+                    std::equal(status.begin(), status.end(), batch.status);
+        printf("%9d %7d %9d %12.1f %12.1f %7.2fx %6s\n", mix[0], mix[1], mix[2], scalar_ns, bitsliced_ns,
+               scalar_ns / bitsliced_ns, same ? "yes" : "NO");
+        std::string mix_name = "c" + std::to_string(mix[0]) + "e" + std::to_string(mix[1]) + "r" + std::to_string(mix[2]);
+        record("bitsliced/" + mix_name + "/scalar", scalar_ns, "ns");
+        record("bitsliced/" + mix_name + "/bitsliced", bitsliced_ns, "ns");
+    }
+}
+
+// The compile-time codec template against the hand-written (63, 42) decoder and encoder, and the
+// template at other rates (ns per frame, errors + erasures at the correction limit and below)
+template<typename Codec>
+double time_codec_decode(size_t frames, int rounds, int num_errors, int num_erasures, std::mt19937& gen) {
+    typedef typename Codec::symbol symbol;
+    std::uniform_int_distribution<> value(0, Codec::field::order), nonzero(1, Codec::field::order);
+    std::vector<symbol> message(Codec::k), received(frames * Codec::n), decoded(Codec::n);
+    std::vector<int> erasures(frames * Codec::parity), positions(Codec::n);
+    for(size_t f = 0; f < frames; f++) {
+        for(auto& m : message) m = value(gen);
+        symbol* r = &received[f * Codec::n];
+        Codec::encode(message.data(), r);
+        for(int i = 0; i < Codec::n; i++) positions[i] = i;
+        std::shuffle(positions.begin(), positions.end(), gen);
+        for(int i = 0; i < num_erasures + num_errors; i++) r[positions[i]] ^= nonzero(gen);
+        std::copy(positions.begin(), positions.begin() + num_erasures, &erasures[f * Codec::parity]);
+    }
+    return best_time(rounds, [&]() {
+        for(size_t f = 0; f < frames; f++) {
+            Codec::decode(&received[f * Codec::n], &erasures[f * Codec::parity], num_erasures, decoded.data());
+        }
+    }) * 1e9 / frames;
+}
+
+void bench_codec(size_t frames, int rounds) {
+    const int mixes[][2] = {{0, 0}, {2, 0}, {5, 0}, {10, 0}, {4, 4}, {0, 21}};
+    std::mt19937 gen(2025);
+    ReedSolomonDecoder decoder;
+    DecoderWorkspace ws;
+    CodewordBatch batch(frames);
+    std::vector<uint8_t> decoded(frames * CodewordBatch::stride);
+
+    printf("Codec template (ns per frame, %zu frames)\n", frames);
+    printf("%7s %9s %12s %12s %6s\n", "errors", "erasures", "decode_frame", "RS63_42", "same");
+    for(const auto& mix : mixes) {
+        make_corrupted_batch(batch, mix[0], mix[1], gen);
+        double frame_ns = best_time(rounds, [&]() {
+            for(size_t f = 0; f < frames; f++) {
+                batch.status[f] = decoder.decode_frame(batch.frame(f), batch.erasure_masks[f], batch.corrected_frame(f), ws);
+            }
+        }) * 1e9 / frames;
+        bool same = true;
+        double codec_ns = best_time(rounds, [&]() {
+            for(size_t f = 0; f < frames; f++) {
+                RS63_42::decode(batch.frame(f), batch.erasure_masks[f], &decoded[f * CodewordBatch::stride]);
+            }
+        }) * 1e9 / frames;
+        for(size_t f = 0; f < frames; f++) same &= memcmp(batch.corrected_frame(f), &decoded[f * CodewordBatch::stride], 63) == 0;
+        printf("%7d %9d %12.1f %12.1f %6s\n", mix[0], mix[1], frame_ns, codec_ns, same ? "yes" : "NO");
+        std::string mix_name = "e" + std::to_string(mix[0]) + "r" + std::to_string(mix[1]);
+        record("codec/" + mix_name + "/decode_frame", frame_ns, "ns");
+        record("codec/" + mix_name + "/template", codec_ns, "ns");
+    }
+
+    // Encoders: the hand-written shift register and the template, same output
+    const size_t messages = frames * 10;
+    const double payload_mb = messages * 42 * 6 / 8.0 / 1e6;
+    std::uniform_int_distribution<> value(0, 63);
+    std::vector<uint8_t> message_data(messages * 42), reference(messages * 64), codewords(messages * 64);
+    for(auto& symbol : message_data) symbol = value(gen);
+    ReedSolomonEncoder encoder;
+    double seconds = best_time(rounds, [&]() {
+        for(size_t f = 0; f < messages; f++) encoder.encodeSystematic(&message_data[f * 42], &reference[f * 64]);
+    });
+    double template_seconds = best_time(rounds, [&]() {
+        for(size_t f = 0; f < messages; f++) RS63_42::encode(&message_data[f * 42], &codewords[f * 64]);
+    });
+    bool same = true;
+    for(size_t f = 0; f < messages; f++) same &= memcmp(&reference[f * 64], &codewords[f * 64], 63) == 0;
+    printf("%-28s %10.1f MB/s\n", "encodeSystematic", payload_mb / seconds);
+    printf("%-28s %10.1f MB/s%s\n", "RS63_42::encode", payload_mb / template_seconds, same ? "" : " (DIFFERENT)");
+    record("codec/encode/encodeSystematic", payload_mb / seconds, "MB/s");
+    record("codec/encode/template", payload_mb / template_seconds, "MB/s");
+
+    // Other instances of the same template
+    printf("%-28s %12s %12s\n", "other codes", "t/2 errors", "t errors");
+    auto other = [&](const char* name, auto run) {
+        double half_ns = run(false), full_ns = run(true);
+        printf("%-28s %12.1f %12.1f\n", name, half_ns, full_ns);
+        record(std::string("codec/") + name + "/half-t", half_ns, "ns");
+        record(std::string("codec/") + name + "/t", full_ns, "ns");
+    };
+    other("RS(255,223)", [&](bool full) {
+        typedef RSCodec<GaloisField<8, 0x11D>, 255, 223, 0> Codec;
+        return time_codec_decode<Codec>(frames / 4, rounds, full ? Codec::t : Codec::t / 2, 0, gen);
+    });
+    other("RS(204,188)", [&](bool full) {
+        typedef RSCodec<GaloisField<8, 0x11D>, 204, 188, 0> Codec;
+        return time_codec_decode<Codec>(frames / 4, rounds, full ? Codec::t : Codec::t / 2, 0, gen);
+    });
+    other("RS(63,53)", [&](bool full) {
+        typedef RSCodec<GF64Field, 63, 53, 1> Codec;
+        return time_codec_decode<Codec>(frames, rounds, full ? Codec::t : Codec::t / 2, 0, gen);
+    });
+}
+
+// Shortened RS(63-s, 42-s) frames: encoding, and decoding clean frames (syndromes only) and
+// frames with errors (syndromes, key equation and the Chien search over 63 - s positions)
+void bench_shortened(size_t frames, int rounds) {
+    const int shortenings[] = {0, 10, 21, 31, 41};
+    std::mt19937 gen(2025);
+    std::uniform_int_distribution<> value(0, 63), nonzero(1, 63);
+    ReedSolomonEncoder encoder;
+    ReedSolomonDecoder decoder;
+    DecoderWorkspace ws;
+    std::vector<uint8_t> clean(frames * 64), received(frames * 64), decoded(64);
+    std::vector<int> positions(63);
+
+    printf("Shortened codes (ns per frame, %zu frames)\n", frames);
+    printf("%4s %8s %10s %10s %10s %10s\n", "s", "length", "encode", "clean", "3 errors", "10 errors");
+    for(int shortening : shortenings) {
+        int length = 63 - shortening, message_length = 42 - shortening;
+        uint8_t message[42];
+        for(size_t f = 0; f < frames; f++) {
+            for(int i = 0; i < message_length; i++) message[i] = value(gen);
+            encoder.encodeShortened(message, message_length, &clean[f * 64]);
+        }
+        double encode_ns = best_time(rounds, [&]() {
+            for(size_t f = 0; f < frames; f++) encoder.encodeShortened(&clean[f * 64], message_length, &received[f * 64]);
+        }) * 1e9 / frames;
+        double decode_ns[3];
+        const int errors[] = {0, 3, 10};
+        for(int e = 0; e < 3; e++) {
+            std::copy(clean.begin(), clean.end(), received.begin());
+            for(size_t f = 0; f < frames; f++) {
+                for(int i = 0; i < length; i++) positions[i] = i;
+                std::shuffle(positions.begin(), positions.begin() + length, gen);
+                for(int i = 0; i < errors[e]; i++) received[f * 64 + positions[i]] ^= nonzero(gen);
+            }
+            decode_ns[e] = best_time(rounds, [&]() {
+                for(size_t f = 0; f < frames; f++) decoder.decode_shortened(&received[f * 64], length, 0, decoded.data(), ws);
+            }) * 1e9 / frames;
+        }
+        printf("%4d %8d %10.1f %10.1f %10.1f %10.1f\n", shortening, length, encode_ns, decode_ns[0], decode_ns[1], decode_ns[2]);
+        std::string name = "shortened/s" + std::to_string(shortening);
+        record(name + "/encode", encode_ns, "ns");
+        record(name + "/clean", decode_ns[0], "ns");
+        record(name + "/e3", decode_ns[1], "ns");
+        record(name + "/e10", decode_ns[2], "ns");
+    }
+}
+
+// Interleaved codec: the blocked transpose against a plain double loop, and decoding blocks
+// hit by one burst of the given length (a quarter of its symbols flagged as erasures)
+void bench_interleave(size_t frames, int rounds) {
+    const int depths[] = {8, 32};
+    std::mt19937 gen(2025);
+    std::uniform_int_distribution<> value(0, 63), nonzero(1, 63);
+
+    printf("Interleaver transpose (ns per codeword)\n");
+    printf("%6s %12s %12s\n", "depth", "plain", "blocked");
+    for(int depth : depths) {
+        size_t blocks = std::max<size_t>(1, frames / depth);
+        std::vector<uint8_t> codewords(blocks * depth * 64), channel(blocks * depth * 63);
+        for(auto& symbol : codewords) symbol = value(gen);
+        double plain_ns = best_time(rounds, [&]() {
+            for(size_t b = 0; b < blocks; b++) {
+                const uint8_t* src = &codewords[b * depth * 64];
+                uint8_t* dst = &channel[b * depth * 63];
+                for(int c = 0; c < depth; c++) {
+                    for(int j = 0; j < 63; j++) dst[j * depth + c] = src[c * 64 + j];
+                }
+            }
+        }) * 1e9 / (blocks * depth);
+        double blocked_ns = best_time(rounds, [&]() {
+            for(size_t b = 0; b < blocks; b++) {
+                transpose_symbols(&codewords[b * depth * 64], 64, &channel[b * depth * 63], depth, depth, 63);
+            }
+        }) * 1e9 / (blocks * depth);
+        printf("%6d %12.2f %12.2f\n", depth, plain_ns, blocked_ns);
+        record("interleave/transpose/d" + std::to_string(depth) + "/plain", plain_ns, "ns");
+        record("interleave/transpose/d" + std::to_string(depth) + "/blocked", blocked_ns, "ns");
+    }
+
+    printf("Interleaved decoding of one burst per block (ns per codeword, %% of codewords decoded)\n");
+    printf("%6s %7s %12s %10s %10s\n", "depth", "burst", "decode", "plain ok%", "ok%");
+    for(int depth : depths) {
+        InterleavedCodec codec(depth);
+        ReedSolomonDecoder decoder;
+        DecoderWorkspace ws;
+        size_t blocks = std::max<size_t>(1, frames / depth);
+        std::vector<uint8_t> messages(depth * 42), sent(depth * 63), received(blocks * depth * 63), flags(blocks * depth * 63);
+        std::vector<uint8_t> decoded(depth * 64), status(depth);
+        for(int burst_per_depth : {8, 12, 16}) {
+            int burst = burst_per_depth * depth;
+            for(size_t b = 0; b < blocks; b++) {
+                for(auto& symbol : messages) symbol = value(gen);
+                codec.encode(messages.data(), &received[b * depth * 63]);
+                uint8_t* block = &received[b * depth * 63];
+                uint8_t* flag = &flags[b * depth * 63];
+                std::fill(flag, flag + depth * 63, 0);
+                int start = gen() % (depth * 63 - burst + 1);
+                for(int p = start; p < start + burst; p++) {
+                    block[p] ^= nonzero(gen);
+                    flag[p] = gen() % 4 == 0;
+                }
+            }
+            long ok = 0;
+            double decode_ns = best_time(rounds, [&]() {
+                ok = 0;
+                for(size_t b = 0; b < blocks; b++) {
+                    ok += depth - codec.decode(&received[b * depth * 63], &flags[b * depth * 63], decoded.data(), status.data());
+                }
+            }) * 1e9 / (blocks * depth);
+            // Each codeword on its own, without the erasure propagation
+            long plain_ok = 0;
+            uint8_t symbols[64], codeword[64];
+            for(size_t b = 0; b < blocks; b++) {
+                for(int c = 0; c < depth; c++) {
+                    uint64_t mask = 0;
+                    for(int j = 0; j < 63; j++) {
+                        symbols[j] = received[b * depth * 63 + j * depth + c];
+                        if(flags[b * depth * 63 + j * depth + c]) mask |= 1ULL << j;
+                    }
+                    DecodeStatus result = decoder.decode_frame(symbols, mask, codeword, ws);
+                    plain_ok += result == DECODE_OK || result == DECODE_CORRECTED;
+                }
+            }
+            printf("%6d %7d %12.1f %9.2f%% %9.2f%%\n", depth, burst, decode_ns, 100.0 * plain_ok / (blocks * depth),
+                   100.0 * ok / (blocks * depth));
+            record("interleave/d" + std::to_string(depth) + "/b" + std::to_string(burst), decode_ns, "ns");
+        }
+    }
+}
+
+// Decoding time against the corruption of the frame: the scalar decoder, the constant-time
+// decoder frame by frame and in bit-sliced groups of 64 (ns per frame, same results checked)
+void bench_constant_time(size_t frames, int rounds) {
+    const int mixes[][2] = {{0, 0}, {1, 0}, {4, 0}, {10, 0}, {0, 21}, {5, 11}, {16, 0}, {0, 30}};
+    std::mt19937 gen(2025);
+    ReedSolomonDecoder decoder;
+    DecoderWorkspace ws;
+    std::unique_ptr<ConstantTimeDecoder> constant_time(new ConstantTimeDecoder());
+    CodewordBatch batch(frames);
+    std::vector<uint8_t> corrected(frames * CodewordBatch::stride), status(frames);
+    double lowest[2] = {1e30, 1e30}, highest[2] = {0, 0};
+
+    printf("Constant-time decoder (ns per frame, %zu frames)\n", frames);
+    printf("%7s %9s %12s %12s %12s %6s\n", "errors", "erasures", "scalar", "ct frame", "ct batch", "same");
+    for(const auto& mix : mixes) {
+        make_corrupted_batch(batch, mix[0], mix[1], gen);
+        double scalar_ns = time_decode_batch(decoder, batch, rounds);
+        std::copy(batch.corrected, batch.corrected + frames * CodewordBatch::stride, corrected.begin());
+        std::copy(batch.status, batch.status + frames, status.begin());
+        double frame_ns = best_time(rounds, [&]() {
+            for(size_t f = 0; f < frames; f++) {
+                batch.status[f] = constant_time->decode_frame(batch.frame(f), batch.erasure_masks[f], batch.corrected_frame(f));
+            }
+        }) * 1e9 / frames;
+        bool same = std::equal(corrected.begin(), corrected.end(), batch.corrected) &&
+                    std::equal(status.begin(), status.end(), batch.status);
+        double batch_ns = best_time(rounds, [&]() { constant_time->decode_batch(batch); }) * 1e9 / frames;
+        same = same && std::equal(corrected.begin(), corrected.end(), batch.corrected) &&
+               std::equal(status.begin(), status.end(), batch.status);
+        printf("%7d %9d %12.1f %12.1f %12.1f %6s\n", mix[0], mix[1], scalar_ns, frame_ns, batch_ns, same ? "yes" : "NO");
+        std::string mix_name = "e" + std::to_string(mix[0]) + "r" + std::to_string(mix[1]);
+        record("constant-time/" + mix_name + "/scalar", scalar_ns, "ns");
+        record("constant-time/" + mix_name + "/frame", frame_ns, "ns");
+        record("constant-time/" + mix_name + "/batch", batch_ns, "ns");
+        lowest[0] = std::min(lowest[0], frame_ns);
+        highest[0] = std::max(highest[0], frame_ns);
+        lowest[1] = std::min(lowest[1], batch_ns);
+        highest[1] = std::max(highest[1], batch_ns);
+    }
+    printf("Spread (slowest / fastest): ct frame %.3f, ct batch %.3f\n", highest[0] / lowest[0], highest[1] / lowest[1]);
+}
+
+int main(int argc, char* argv[]) {
+    std::string section = "all";
+    size_t frames = 20000;
+    int rounds = 5;
+    const char* output = nullptr;
+    const char* baseline = nullptr;
+    double tolerance = 10;
+    // Positional arguments, in order: section, frames, rounds
+    int positional = 0;
+    for(int i = 1; i < argc; i++) {
+        if(strcmp(argv[i], "--output") == 0 && i + 1 < argc) output = argv[++i];
+        else if(strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) baseline = argv[++i];
+        else if(strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc) tolerance = atof(argv[++i]);
+        else if(argv[i][0] != '-' && positional < 3) {
+            if(positional == 0) section = argv[i];
+            else if(positional == 1) frames = strtoul(argv[i], nullptr, 10);
+            else rounds = atoi(argv[i]);
+            positional++;
+        }
+        else {
+            fprintf(stderr, "Usage: %s [all|stages|syndromes|key-equation|encoder|bitsliced|gmd|codec|shortened|interleave|constant-time|transform] [frames] [rounds]\n"
+                            "       [--output FILE] [--baseline FILE] [--tolerance PERCENT]\n", argv[0]);
+            return 1;
+        }
+    }
+    if(section == "all" || section == "stages") DecoderStageBenchmark::run(frames, rounds);
+    if(section == "all" || section == "syndromes") bench_syndromes(frames, rounds);
+    if(section == "all" || section == "key-equation") bench_key_equation(frames, rounds);
+    if(section == "all" || section == "encoder") bench_encoder(frames * 10, rounds);
+    if(section == "all" || section == "bitsliced") bench_bitsliced(frames, rounds);
+    if(section == "all" || section == "gmd") bench_gmd(frames, rounds);
+    if(section == "all" || section == "codec") bench_codec(frames, rounds);
+    if(section == "all" || section == "shortened") bench_shortened(frames, rounds);
+    if(section == "all" || section == "interleave") bench_interleave(frames, rounds);
+    if(section == "all" || section == "constant-time") bench_constant_time(frames, rounds);
+    if(section == "all" || section == "transform") DecoderStageBenchmark::run_transform(frames, rounds);
+    if(output != nullptr && !write_results(output)) {
+        fprintf(stderr, "Cannot write %s\n", output);
+        return 1;
+    }
+    if(baseline != nullptr) {
+        int regressions = compare_baseline(baseline, tolerance);
+        if(regressions < 0) {
+            fprintf(stderr, "Cannot read %s\n", baseline);
+            return 1;
+        }
+        printf("%d regression%s\n", regressions, regressions == 1 ? "" : "s");
+        if(regressions > 0) return 2;
+    }
+    return 0;
+}
@@ -1,22 +1,11 @@
 #include <iostream>
 #include <vector>
 #include <string>
-
-// Power table for GF(64)
-int pow_table[63] = {1, 2, 4, 8, 16, 32, 3, 6, 12, 24, 48, 35, 5, 10, 20, 40, 19, 38, 15,
-                     30, 60, 59, 53, 41, 17, 34, 7, 14, 28, 56, 51, 37, 9, 18, 36, 11, 22, 44,
-                     27, 54, 47, 29, 58, 55, 45, 25, 50, 39, 13, 26, 52, 43, 21, 42, 23, 46, 31, 
-                     62, 63, 61, 57, 49, 33};
-
-class GF64 {
-    private:
-        int value;
-    public:
-        GF64() { this->value = 0; }
-        GF64(int value) { this->value = value; }
-        int get_value() const { return value; }
-        void set_value(int value) { this->value = value; }
-};
+#include <cstdio>
+#include <cstring>
+#include "gf64.h"
+#include "rs_text.h"
+#include "rs_wire.h"
 
 // Calculate distance between two codewords
 // Returns a pair of (total_distance, num_errors, num_erasures)
@@ -42,44 +31,71 @@ std::pair<int, std::pair<int, int>> calculate_distance(const std::vector<GF64>&
     return {total_distance, {num_errors, num_erasures}};
 }
 
-int main() {
-    // Read first codeword
-    std::vector<GF64> word1(63);
-    std::cout << "Enter first codeword (63 values, use * for erasures):\n";
-    for(int i = 0; i < 63; i++) {
-        char c;
-        std::cin >> c;
-        if(c == '*') {
-            word1[i] = GF64(-1);  // -1 represents erasure
-        } else {
-            std::cin.unget();
-            int x;
-            std::cin >> x;
-            if(x < 0 || x > 63) {
-                std::cout << "Invalid input: values must be between 0 and 63\n";
-                return 1;
-            }
-            word1[i] = GF64(x);
+// Compare two binary frame streams (rs_wire.h) frame by frame, one line per frame and the totals
+int compare_streams(const char* path1, const char* path2) {
+    FILE* file1 = fopen(path1, "rb");
+    FILE* file2 = fopen(path2, "rb");
+    if(file1 == nullptr || file2 == nullptr) {
+        std::cerr << "Error: cannot open " << (file1 == nullptr ? path1 : path2) << "\n";
+        return 1;
+    }
+    FrameReader reader1(file1), reader2(file2);
+    if(!reader1.read_header() || !reader2.read_header()) {
+        std::cerr << "Error: the inputs are not RS(63,42) frame streams\n";
+        return 1;
+    }
+    uint8_t symbols1[64], symbols2[64];
+    uint64_t mask1, mask2;
+    std::vector<GF64> word1(63), word2(63);
+    long frames = 0, total_errors = 0, total_erasures = 0;
+    while(reader1.read(symbols1, mask1) && reader2.read(symbols2, mask2)) {
+        // -1 represents erasure, as in the text input
+        for(int i = 0; i < 63; i++) {
+            word1[i] = ((mask1 >> i) & 1) ? GF64(-1) : GF64(symbols1[i]);
+            word2[i] = ((mask2 >> i) & 1) ? GF64(-1) : GF64(symbols2[i]);
         }
+        auto [total_distance, counts] = calculate_distance(word1, word2);
+        auto [num_errors, num_erasures] = counts;
+        std::cout << "Frame " << frames << ": distance " << total_distance << ", errors " << num_errors
+                  << ", erasures " << num_erasures << "\n";
+        frames++;
+        total_errors += num_errors;
+        total_erasures += num_erasures;
     }
-    
-    // Read second codeword
-    std::vector<GF64> word2(63);
-    std::cout << "Enter second codeword (63 values, use * for erasures):\n";
-    for(int i = 0; i < 63; i++) {
-        char c;
-        std::cin >> c;
-        if(c == '*') {
-            word2[i] = GF64(-1);  // -1 represents erasure
-        } else {
-            std::cin.unget();
-            int x;
-            std::cin >> x;
-            if(x < 0 || x > 63) {
-                std::cout << "Invalid input: values must be between 0 and 63\n";
-                return 1;
-            }
-            word2[i] = GF64(x);
+    std::cout << "Frames: " << frames << ", errors: " << total_errors << ", erasures: " << total_erasures << "\n";
+    fclose(file1);
+    fclose(file2);
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    // --binary FILE1 FILE2 compares two binary frame streams without prompts
+    if(argc == 4 && strcmp(argv[1], "--binary") == 0) return compare_streams(argv[2], argv[3]);
+    if(argc != 1) {
+        std::cerr << "Usage: " << argv[0] << " [--binary FILE1 FILE2]\n";
+        return 1;
+    }
+    // Read the two codewords, -1 represents erasure
+    TextFrameReader reader(stdin);
+    std::vector<GF64> word1(63), word2(63);
+    const char* prompts[2] = {"Enter first codeword (63 values, use * for erasures):",
+                              "Enter second codeword (63 values, use * for erasures):"};
+    std::vector<GF64>* words[2] = {&word1, &word2};
+    for(int w = 0; w < 2; w++) {
+        std::cout << prompts[w] << std::endl;
+        uint8_t symbols[64];
+        uint64_t erasure_mask;
+        TextParseError error;
+        if(!reader.read(symbols, erasure_mask, error)) {
+            std::cout << "Invalid input: no codeword\n";
+            return 1;
+        }
+        if(error.reason != nullptr) {
+            report_text_error(stdout, error);
+            return 1;
+        }
+        for(int i = 0; i < 63; i++) {
+            (*words[w])[i] = ((erasure_mask >> i) & 1) ? GF64(-1) : GF64(symbols[i]);
         }
     }
     
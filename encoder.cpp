@@ -1,247 +1,97 @@
 #include <iostream>
 #include <vector>
 #include <string>
+#include <climits>
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <ctime>
+#include "rs_encoder.h"
+#include "rs_wire.h"
 
+// Parse the --count argument: a whole decimal number 0 or more, or -1 if it is not one
+long parse_count(const char* text) {
+    char* end;
+    long value = strtol(text, &end, 10);
+    if (end == text || *end != '\0' || value < 0 || value == LONG_MAX) return -1;
+    return value;
+}
 
-class GF64;
-// Power table for GF(64)
-int pow_table[63] = {1, 2, 4, 8, 16, 32, 3, 6, 12, 24, 48, 35, 5, 10, 20, 40, 19, 38, 15,
-                     30, 60, 59, 53, 41, 17, 34, 7, 14, 28, 56, 51, 37, 9, 18, 36, 11, 22, 44,
-                     27, 54, 47, 29, 58, 55, 45, 25, 50, 39, 13, 26, 52, 43, 21, 42, 23, 46, 31, 
-                     62, 63, 61, 57, 49, 33};
-// Logarithm table for GF(64)
-int log_table[64];
-// Coefficients of the generator polynomial for the Reed-Solomon code
-const int gen_poly[22] = {58, 62, 59, 7, 35, 58, 63, 47, 51, 6, 33, 43, 44, 27, 7, 53, 39, 62, 52, 41, 44, 1};
-
-class GF64 {
-    private:
-        int value; // Saves the coefficient of the polynomial
-    public:
-        // Constructor
-        GF64() {
-            this->value = 0;
-        }
-        GF64(int value) {
-            this->value = value;
-        }
-        // Add the polynomial
-        GF64 operator+(const GF64& other) const {
-            // Simple XOR operation
-            return GF64(value ^ other.value);
-        }
-        // Multiply the polynomial
-        GF64 operator*(const GF64& other) const {
-            // Use the log table to find the power of the polynomial
-            if(value == 0 || other.get_value() == 0) {
-                return GF64(0);
-            }
-            int log_value = log_table[value] + log_table[other.get_value()];
-            return GF64(pow_table[log_value % 63]);
-        }
-        // Divide the polynomial
-        GF64 operator/(const GF64& other) const {
-            // Use the log table to find the power of the polynomial
-            int log_value = log_table[value] - log_table[other.get_value()];
-            return GF64(pow_table[log_value % 63]);
-        }
-        // Assign the value of the polynomial
-        GF64 operator=(const GF64& other) {
-            this->value = other.value;
-            return *this;
-        }
-        // Get the value of the polynomial
-        int get_value() const {
-            return value;
-        }
-        // Set the value of the polynomial
-        void set_value(int value) {
-            this->value = value;
-        }
-};
-
-class GF64_poly {
-    public:
-        std::vector<GF64> coefficients;
-        int degree;
-        
-        GF64_poly(int degree) {
-            coefficients.resize(degree + 1);
-            for(int i = 0; i < coefficients.size(); i++) {
-                coefficients[i] = GF64(0);
-            }
-            this->degree = degree;
-        }
-        
-        GF64_poly(const std::vector<GF64>& coefficients) {
-            this->coefficients = coefficients;
-            this->degree = coefficients.size() - 1;
-        }
-        
-        GF64_poly operator+(const GF64_poly& other) const {
-            std::vector<GF64> result(std::max(degree, other.degree) + 1, GF64(0));
-            for(int i = 0; i <= degree; i++) {
-                result[i] = coefficients[i];
-            }
-            for(int i = 0; i <= other.degree; i++) {
-                result[i] = result[i] + other.coefficients[i];
-            }
-            
-            // Remove leading zeros while keeping at least one term
-            while(result.size() > 1 && result.back().get_value() == 0) {
-                result.pop_back();
-            }
-            return GF64_poly(result);
-        }
-        
-        GF64_poly operator*(const GF64_poly& other) const {
-            // Initialize result with zeros
-            std::vector<GF64> result(degree + other.degree + 1, GF64(0));
-            
-            // Perform polynomial multiplication
-            for(int i = 0; i <= degree; i++) {
-                if(coefficients[i].get_value() != 0) {  // Skip zero terms
-                    for(int j = 0; j <= other.degree; j++) {
-                        if(other.coefficients[j].get_value() != 0) {  // Skip zero terms
-                            result[i+j] = result[i+j] + coefficients[i] * other.coefficients[j];
-                        }
-                    }
-                }
-            }
-            
-            // Remove leading zeros while keeping at least one term
-            while(result.size() > 1 && result.back().get_value() == 0) {
-                result.pop_back();
-            }
-            return GF64_poly(result);
-        }
-        
-        GF64_poly operator*(const GF64& other) const {
-            std::vector<GF64> result(degree + 1);
-            for(int i = 0; i <= degree; i++) {
-                result[i] = coefficients[i] * other;
-            }
-            
-            // Remove leading zeros while keeping at least one term
-            while(result.size() > 1 && result.back().get_value() == 0) {
-                result.pop_back();
+// Example usage
+int main(int argc, char* argv[]) {
+    // --systematic puts the message in the first 42 symbols, followed by the 21 parity symbols
+    // --binary writes --count codewords as a binary frame stream (rs_wire.h) instead of text
+    // --shortened S encodes 42 - S message symbols into the 63 - S symbols of the shortened
+    // RS(63-S, 42-S) code (systematic, text only)
+    bool systematic = false, binary = false;
+    long count = 1;
+    bool count_given = false;
+    int shortening = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--systematic") == 0) systematic = true;
+        else if (strcmp(argv[i], "--binary") == 0) binary = true;
+        else if (strcmp(argv[i], "--count") == 0 && i + 1 < argc) {
+            count = parse_count(argv[++i]);
+            if (count < 0) {
+                std::cerr << "Invalid count: " << argv[i] << " (use a whole number, 0 or more)" << std::endl;
+                return 1;
             }
-            return GF64_poly(result);
+            count_given = true;
         }
-        
-        GF64_poly operator/(const GF64_poly& other) const {
-            // Check for division by zero polynomial
-            if(other.degree == 0 && other.coefficients[0].get_value() == 0) {
-                throw std::invalid_argument("Division by zero polynomial");
-            }
-            
-            if(degree < other.degree) {
-                return GF64_poly(0);
+        else if (strcmp(argv[i], "--shortened") == 0 && i + 1 < argc) {
+            shortening = atoi(argv[++i]);
+            if (shortening < 0 || shortening > 41) {
+                std::cerr << "Invalid shortening: " << argv[i] << " (use 0~41)" << std::endl;
+                return 1;
             }
-            
-            std::vector<GF64> quotient(degree - other.degree + 1, GF64(0));
-            std::vector<GF64> remainder = coefficients;
-            
-            for(int i = degree; i >= other.degree; i--) {
-                if(remainder[i].get_value() != 0) {
-                    GF64 coef = remainder[i] / other.coefficients[other.degree];
-                    quotient[i - other.degree] = coef;
-                    
-                    for(int j = 0; j <= other.degree; j++) {
-                        remainder[i - j] = remainder[i - j] + 
-                            other.coefficients[other.degree - j] * coef;
-                    }
-                }
-            }
-            
-            // Remove leading zeros while keeping at least one term
-            while(quotient.size() > 1 && quotient.back().get_value() == 0) {
-                quotient.pop_back();
-            }
-            return GF64_poly(quotient);
-        }
-        
-        GF64_poly operator=(const GF64_poly& other) {
-            this->coefficients = other.coefficients;
-            this->degree = other.degree;
-            return *this;
         }
-        
-        GF64_poly operator=(const std::vector<GF64>& coefficients) {
-            this->coefficients = coefficients;
-            this->degree = coefficients.size() - 1;
-            return *this;
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--systematic] [--shortened S] [--binary [--count N]]" << std::endl;
+            return 1;
         }
-};
-
-
-class ReedSolomonEncoder {
-private:
-    static const int n = 63;  // Code length
-    static const int k = 42;  // Message length
-    static const int t = 10;  // Error correction capability
-
-public:
-    // Create generator polynomial
-    GF64_poly createGeneratorPolynomial() {
-        std::vector<GF64> gen_coeffs(22);
-        for(int i = 0; i < 22; i++) {
-            gen_coeffs[i] = GF64(gen_poly[i]);
-        }
-        return GF64_poly(gen_coeffs);
     }
-    // Encode a message into a codeword
-    
-    std::vector<GF64> encode(const std::vector<GF64>& message) {
-        if (message.size() != k) {
-            throw std::invalid_argument("Message length must be " + std::to_string(k));
-        }
-        
-        // Create message polynomial
-        GF64_poly message_poly(message);
-        
-        // Create generator polynomial
-        GF64_poly gen_poly = createGeneratorPolynomial();
-        
-        // Multiply polynomials
-        GF64_poly codeword_poly = message_poly * gen_poly;
-        
-        // Convert to vector and ensure length is n
-        std::vector<GF64> codeword = codeword_poly.coefficients;
-        codeword.resize(n, GF64(0));  // Pad with zeros if necessary
-        
-        return codeword;
+    if (count_given && !binary) {
+        std::cerr << "--count works with --binary only" << std::endl;
+        return 1;
     }
+    if (shortening > 0 && binary) {
+        std::cerr << "--shortened works with text output only" << std::endl;
+        return 1;
+    }
+    // Seed the random number generator
+    srand(time(0));
 
-    // Encode a message from raw integers
-    std::vector<GF64> encodeFromInts(const std::vector<int>& message) {
-        if (message.size() != k) {
-            throw std::invalid_argument("Message length must be " + std::to_string(k));
-        }
+    // Create encoder
+    ReedSolomonEncoder encoder;
 
-        std::vector<GF64> gfMessage;
-        for (int value : message) {
-            gfMessage.push_back(GF64(value));
+    if (binary) {
+        FrameWriter writer(stdout);
+        writer.write_header();
+        uint8_t message[42] = {0}, codeword[64];
+        for (long f = 0; f < count; f++) {
+            for (int i = 0; i < 42; i++) message[i] = rand() % 64;
+            if (systematic) encoder.encodeSystematic(message, codeword);
+            else {
+                std::vector<int> values(message, message + 42);
+                std::vector<GF64> symbols = encoder.encodeFromInts(values, false);
+                for (int i = 0; i < 63; i++) codeword[i] = symbols[i].get_value();
+            }
+            writer.write(codeword, 0);
         }
-        
-        return encode(gfMessage);
+        return 0;
     }
-};
 
-// Example usage
-int main() {
-    // Initialize logarithm table
-    srand(time(0));
-    log_table[0] = 0;
-    for(int i = 1; i < 64; i++) {
-        log_table[pow_table[i-1]] = i-1;
+    if (shortening > 0) {
+        // The implied zero symbols are not written
+        int message_length = 42 - shortening;
+        uint8_t message[42] = {0}, codeword[64];
+        for (int i = 0; i < message_length; i++) message[i] = rand() % 64;
+        encoder.encodeShortened(message, message_length, codeword);
+        for (int i = 0; i < message_length + 21; i++) std::cout << (int)codeword[i] << " ";
+        std::cout << std::endl;
+        return 0;
     }
 
-    // Create encoder
-    ReedSolomonEncoder encoder;
-
     // Example message (42 symbols)
     // Randomly generate 42 symbols
     std::vector<int> message(42);
@@ -250,7 +100,7 @@ int main() {
     }
 
     // Encode the message
-    std::vector<GF64> codeword = encoder.encodeFromInts(message);
+    std::vector<GF64> codeword = encoder.encodeFromInts(message, systematic);
 
     // Output the complete codeword
     for (const auto& symbol : codeword) {
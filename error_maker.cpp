@@ -5,52 +5,17 @@
 #include <ctime>
 #include <algorithm>
 #include <random>
+#include <cstring>
+#include "gf64.h"
+#include "rs_wire.h"
 
-// Power table for GF(64)
-int pow_table[63] = {1, 2, 4, 8, 16, 32, 3, 6, 12, 24, 48, 35, 5, 10, 20, 40, 19, 38, 15,
-                     30, 60, 59, 53, 41, 17, 34, 7, 14, 28, 56, 51, 37, 9, 18, 36, 11, 22, 44,
-                     27, 54, 47, 29, 58, 55, 45, 25, 50, 39, 13, 26, 52, 43, 21, 42, 23, 46, 31, 
-                     62, 63, 61, 57, 49, 33};
-// Logarithm table for GF(64)
-int log_table[64];
-
-// Include the same GF64 class and tables from proj2.cpp
-class GF64 {
-    private:
-        int value;
-    public:
-        GF64() { this->value = 0; }
-        GF64(int value) { this->value = value; }
-        GF64 operator+(const GF64& other) const {
-            return GF64(value ^ other.value);
-        }
-        GF64 operator*(const GF64& other) const {
-            if(value == 0 || other.get_value() == 0) {
-                return GF64(0);
-            }
-            int log_value = log_table[value] + log_table[other.get_value()];
-            return GF64(pow_table[log_value % 63]);
-        }
-        int get_value() const { return value; }
-        void set_value(int value) { this->value = value; }
-};
-
-void initialize_tables() {
-    log_table[0] = 0;
-    for(int i = 1; i < 64; i++) {
-        log_table[pow_table[i-1]] = i-1;
-    }
-}
-
+// num_errors + num_erasures must be 63 or less (see valid_counts)
 std::vector<GF64> generate_corrupted_codeword(const std::vector<GF64>& original, 
                                             int num_errors, 
-                                            int num_erasures) {
+                                            int num_erasures,
+                                            std::mt19937& gen) {
     std::vector<GF64> corrupted = original;
     std::vector<bool> used_positions(63, false);
-    
-    // Random number generator
-    std::random_device rd;
-    std::mt19937 gen(rd());
     std::uniform_int_distribution<> dis(0, 62);
     
     // Generate erasures
@@ -84,9 +49,59 @@ std::vector<GF64> generate_corrupted_codeword(const std::vector<GF64>& original,
     return corrupted;
 }
 
-int main() {
-    initialize_tables();
-    
+// Counts of errors and erasures that fit in one codeword
+bool valid_counts(int num_errors, int num_erasures) {
+    return num_errors >= 0 && num_erasures >= 0 && num_errors + num_erasures <= 63;
+}
+
+// Parse a count argument: a whole decimal number 0~63, or -1 if it is not one
+int parse_count(const char* text) {
+    char* end;
+    long value = strtol(text, &end, 10);
+    if(end == text || *end != '\0' || value < 0 || value > 63) return -1;
+    return (int)value;
+}
+
+// Corrupt every frame of a binary frame stream from stdin and write them to stdout
+int corrupt_stream(int num_errors, int num_erasures) {
+    FrameReader reader(stdin);
+    if(!reader.read_header()) {
+        std::cerr << "Error: the input is not a RS(63,42) frame stream\n";
+        return 1;
+    }
+    FrameWriter writer(stdout);
+    writer.write_header();
+    uint8_t symbols[64];
+    uint64_t erasure_mask;
+    std::vector<GF64> original(63);
+    // One generator for the whole stream
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    while(reader.read(symbols, erasure_mask)) {
+        for(int i = 0; i < 63; i++) original[i] = GF64(symbols[i]);
+        std::vector<GF64> corrupted = generate_corrupted_codeword(original, num_errors, num_erasures, gen);
+        // The erasures already in the frame stay, the new ones are added to them
+        for(int i = 0; i < 63; i++) {
+            if(corrupted[i].get_value() == -1) erasure_mask |= 1ULL << i;
+            // Erased symbols are sent as 0, also when an error landed on an old erasure
+            symbols[i] = (erasure_mask >> i) & 1 ? 0 : corrupted[i].get_value();
+        }
+        writer.write(symbols, erasure_mask);
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    // --binary ERRORS ERASURES corrupts a whole binary frame stream (rs_wire.h) without prompts
+    if(argc == 4 && strcmp(argv[1], "--binary") == 0) {
+        int num_errors = parse_count(argv[2]), num_erasures = parse_count(argv[3]);
+        if(valid_counts(num_errors, num_erasures)) return corrupt_stream(num_errors, num_erasures);
+    }
+    if(argc != 1) {
+        std::cerr << "Usage: " << argv[0] << " [--binary ERRORS ERASURES]\n"
+                  << "ERRORS and ERASURES are 0~63, and together at most 63\n";
+        return 1;
+    }
     // Read original codeword
     std::vector<GF64> original(63);
     std::cout << "Enter the original codeword (63 values, 0-63):\n";
@@ -106,9 +121,15 @@ int main() {
     std::cin >> num_errors;
     std::cout << "Enter number of erasures: ";
     std::cin >> num_erasures;
+    if(!std::cin || !valid_counts(num_errors, num_erasures)) {
+        std::cout << "Invalid input: errors and erasures must be 0 or more, and together at most 63\n";
+        return 1;
+    }
     
     // Generate corrupted codeword
-    std::vector<GF64> corrupted = generate_corrupted_codeword(original, num_errors, num_erasures);
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::vector<GF64> corrupted = generate_corrupted_codeword(original, num_errors, num_erasures, gen);
     
     // Output the corrupted codeword
     std::cout << "Corrupted codeword:\n";
@@ -0,0 +1,103 @@
+#ifndef GF64_H
+#define GF64_H
+
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+
+// GF(64) arithmetic shared by every tool
+// The field is built from the primitive polynomial x^6 + x + 1 (a^6 = a + 1), and all the
+// tables below are generated at compile time, so they are immutable and need no setup in main().
+
+// Primitive polynomial of GF(64): x^6 + x + 1
+const int gf64_primitive_poly = 0x43;
+
+// Power table for GF(64): pow_table[i] = a^i, i = 0~62
+constexpr std::array<uint8_t, 63> make_pow_table() {
+    std::array<uint8_t, 63> table{};
+    int value = 1;
+    for(int i = 0; i < 63; i++) {
+        table[i] = value;
+        value <<= 1;
+        if(value & 64) value ^= gf64_primitive_poly;
+    }
+    return table;
+}
+inline constexpr std::array<uint8_t, 63> pow_table = make_pow_table();
+
+// Logarithm table for GF(64): log_table[a^i] = i (log_table[0] is unused and set to 0)
+constexpr std::array<uint8_t, 64> make_log_table() {
+    std::array<uint8_t, 64> table{};
+    for(int i = 0; i < 63; i++) table[pow_table[i]] = i;
+    return table;
+}
+inline constexpr std::array<uint8_t, 64> log_table = make_log_table();
+
+// Full product table: mul_table[x][y] = x * y (4 KB)
+constexpr std::array<std::array<uint8_t, 64>, 64> make_mul_table() {
+    std::array<std::array<uint8_t, 64>, 64> table{};
+    for(int x = 1; x < 64; x++) {
+        for(int y = 1; y < 64; y++) {
+            table[x][y] = pow_table[(log_table[x] + log_table[y]) % 63];
+        }
+    }
+    return table;
+}
+inline constexpr std::array<std::array<uint8_t, 64>, 64> mul_table = make_mul_table();
+
+// Inverse table: inv_table[x] = 1 / x (inv_table[0] is unused and set to 0)
+constexpr std::array<uint8_t, 64> make_inv_table() {
+    std::array<uint8_t, 64> table{};
+    for(int x = 1; x < 64; x++) table[x] = pow_table[(63 - log_table[x]) % 63];
+    return table;
+}
+inline constexpr std::array<uint8_t, 64> inv_table = make_inv_table();
+
+static_assert(pow_table[6] == 3 && pow_table[62] == 33, "GF(64) power table mismatch");
+static_assert(mul_table[32][2] == 3 && mul_table[33][2] == 1, "GF(64) product table mismatch");
+static_assert(mul_table[45][inv_table[45]] == 1, "GF(64) inverse table mismatch");
+
+class GF64 {
+    private:
+        int value; // Saves the coefficient of the polynomial
+    public:
+        GF64() { this->value = 0; }
+        GF64(int value) { this->value = value; }
+        // Add the polynomial
+        GF64 operator+(const GF64& other) const {
+            // Simple XOR operation
+            return GF64(value ^ other.value);
+        }
+        // Multiply the polynomial
+        GF64 operator*(const GF64& other) const {
+            // One lookup in the product table (the zero row and column are all 0)
+            return GF64(mul_table[value][other.value]);
+        }
+        // Divide the polynomial
+        GF64 operator/(const GF64& other) const {
+            // If the other number is 0, the result is undefined
+            if(other.value == 0)
+                throw std::invalid_argument("Division by zero");
+            return GF64(mul_table[value][inv_table[other.value]]);
+        }
+        // Get the inverse of the GF64 number (the inverse of 0 is returned as 0)
+        GF64 inverse() const {
+            return GF64(inv_table[value]);
+        }
+        bool operator==(const GF64& other) const {
+            return value == other.value;
+        }
+        bool operator!=(const GF64& other) const {
+            return value != other.value;
+        }
+        // Get the value of the GF64 number
+        int get_value() const {
+            return value;
+        }
+        // Set the value of the GF64 number
+        void set_value(int value) {
+            this->value = value;
+        }
+};
+
+#endif
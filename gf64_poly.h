@@ -0,0 +1,318 @@
+#ifndef GF64_POLY_H
+#define GF64_POLY_H
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+#include "gf64.h"
+
+class GF64_poly {
+    private:
+        // The coefficients of the polynomial (The first element is the constant term)
+        std::vector<GF64> coefficients;
+        int degree; 
+    public:
+        GF64_poly() {
+            degree = 0;
+            coefficients.resize(1);
+            coefficients[0] = GF64(0);
+        }
+        GF64_poly(const std::vector<GF64>& coefficients) {
+            this->coefficients = coefficients;
+            this->degree = coefficients.size() - 1;
+            while(degree > 0 && coefficients[degree].get_value() == 0) degree--;
+        }
+        // Set the coefficients of the polynomial
+        GF64_poly set_coefficients(int index, GF64 value) {
+            // If the index is greater than the degree, resize the polynomial
+            if(index > degree){
+                degree = index;
+                coefficients.resize(degree + 1);
+            }
+            coefficients[index] = value;
+            return *this;
+        }
+        // Get the degree of the polynomial
+        int get_degree() const {
+            return degree;
+        }
+        // Add two polynomials
+        GF64_poly operator+(const GF64_poly& other) const {
+            // Initialize the result with zeros, the result's degree is the maximum degree of the two polynomials
+            std::vector<GF64> result(std::max(degree, other.degree) + 1, GF64(0));
+            for(int i = 0; i <= degree; i++) result[i] = coefficients[i];
+            for(int i = 0; i <= other.degree; i++) result[i] = result[i] + other.coefficients[i];
+            // Remove leading zeros while keeping at least one term
+            while(result.size() > 1 && result.back().get_value() == 0) result.pop_back();
+            return GF64_poly(result);
+        }
+        // Multiply a polynomial and a GF64 number
+        GF64_poly operator*(const GF64& other) const {
+            // Initialize the result with zeros, the result's degree is the degree of the polynomial
+            std::vector<GF64> result(degree + 1);
+            for(int i = 0; i <= degree; i++) {
+                result[i] = coefficients[i] * other;
+            }
+            // Remove leading zeros while keeping at least one term
+            while(result.size() > 1 && result.back().get_value() == 0) {
+                result.pop_back();
+            }
+            return GF64_poly(result);
+        }
+        // Multiply two polynomials
+        GF64_poly operator*(const GF64_poly& other) const {
+            // Initialize result with zeros, the result's degree is the sum of the degrees of the two polynomials
+            std::vector<GF64> result(degree + other.degree + 1, GF64(0));
+            // Perform polynomial multiplication
+            for(int i = 0; i <= degree; i++) {
+                if(coefficients[i].get_value() != 0) {  // Skip zero terms
+                    for(int j = 0; j <= other.degree; j++) {
+                        if(other.coefficients[j].get_value() != 0) {  // Skip zero terms
+                            result[i+j] = result[i+j] + coefficients[i] * other.coefficients[j];
+                        }
+                    }
+                }
+            }
+            // Remove leading zeros while keeping at least one term
+            while(result.size() > 1 && result.back().get_value() == 0) result.pop_back();
+            return GF64_poly(result);
+        }
+        // Divide by another polynomial, Y = X * Q + R
+        // Returns false (and leaves quotient and remainder untouched) if the divisor is 0
+        bool divide(const GF64_poly& divisor, GF64_poly& quotient, GF64_poly& remainder) const {
+            if(divisor.is_zero()) return false;
+            // If the degree of the polynomial is less than the degree of the divisor, the quotient is 0
+            if(degree < divisor.degree) {
+                quotient = GF64_poly();
+                remainder = *this;
+                return true;
+            }
+            // The quotient's degree is the degree of the polynomial minus the degree of the divisor
+            std::vector<GF64> q(degree - divisor.degree + 1, GF64(0));
+            std::vector<GF64> r = coefficients;
+            GF64 lead_inverse = divisor.coefficients[divisor.degree].inverse();
+            for(int i = degree; i >= divisor.degree; i--) {
+                // If the leading coefficient of the remainder is not 0
+                if(r[i].get_value() == 0) continue;
+                GF64 coef = r[i] * lead_inverse;
+                q[i - divisor.degree] = coef;
+                for(int j = 0; j <= divisor.degree; j++) {
+                    r[i - j] = r[i - j] + divisor.coefficients[divisor.degree - j] * coef;
+                }
+            }
+            // Remove leading zeros while keeping at least one term
+            while(q.size() > 1 && q.back().get_value() == 0) q.pop_back();
+            while(r.size() > 1 && r.back().get_value() == 0) r.pop_back();
+            quotient = GF64_poly(q);
+            remainder = GF64_poly(r);
+            return true;
+        }
+        // Divide a polynomial by another polynomial
+        // A zero divisor throws std::invalid_argument like GF64::operator/, divide() returns false instead
+        GF64_poly operator/(const GF64_poly& other) const {
+            GF64_poly quotient, remainder;
+            if(!divide(other, quotient, remainder)) throw std::invalid_argument("Division by zero polynomial");
+            return quotient;
+        }
+        // Remainder of the division by another polynomial
+        GF64_poly operator%(const GF64_poly& other) const {
+            GF64_poly quotient, remainder;
+            if(!divide(other, quotient, remainder)) throw std::invalid_argument("Modulo by zero polynomial");
+            return remainder;
+        }
+        
+        GF64_poly operator=(const GF64_poly& other) {
+            this->coefficients = other.coefficients;
+            this->degree = other.degree;
+            return *this;
+        }
+        
+        GF64_poly operator=(const std::vector<GF64>& coefficients) {
+            this->coefficients = coefficients;
+            this->degree = coefficients.size() - 1;
+            // Remove leading zeros while keeping at least one term
+            while(degree > 0 && coefficients[degree].get_value() == 0) {
+                degree--;
+            }
+            return *this;
+        }
+        // Evaluate the polynomial at a given number
+        GF64 operator()(const GF64& x) const {
+            // If the number is 0, the result is the constant term
+            if(x.get_value() == 0){
+                return coefficients[0];
+            }
+            GF64 result(0), power(1);
+            for(int i = 0; i <= degree; i++){
+                result = result + coefficients[i] * power;
+                // Update the power (a^i)
+                power = power * x;
+            }
+            return result;
+        }
+        GF64_poly differentiate() const {
+            GF64_poly result;
+            // If the degree is even, the result is the coefficient of the polynomial
+            // Otherwise, the result is 0 (1+1=0 in GF(64))
+            for(int i = 0; i < degree; i++){
+                if(i % 2 == 0){
+                    result.set_coefficients(i, coefficients[i+1]);
+                }
+                else result.set_coefficients(i, 0);
+            }
+            return result;
+        }
+        // Get the coefficient of x^index (0 if the index is beyond the degree)
+        GF64 get_coefficient(int index) const {
+            if(index > degree) return GF64(0);
+            return coefficients[index];
+        }
+        void print() const {
+            for(int i = 0; i < coefficients.size(); i++){
+                printf("%d ", coefficients[i].get_value());
+            }
+            printf("\n");
+        }
+        bool is_zero() const {
+            return degree == 0 && coefficients[0].get_value() == 0;
+        }
+        GF64_poly mod_x21() const {
+            // The result is simply the polynomial dropping all the terms with degree greater than 20
+            GF64_poly result;
+            for(int i = 20; i >= 0; i--){
+                if(get_coefficient(i).get_value() != 0)
+                    result.set_coefficients(i, get_coefficient(i));
+            }
+            return result;
+        }
+};
+
+// Polynomial over GF(64) with a fixed capacity of 64 coefficients (degree <= 63)
+// The coefficients live inside the object, so the decode path never touches the heap.
+// Coefficients above the degree are always kept at 0.
+class GF64_fixed_poly {
+    public:
+        static const int capacity = 64;
+    private:
+        // The coefficients of the polynomial (The first element is the constant term)
+        GF64 coefficients[capacity];
+        int degree;
+        // Lower the degree until the leading coefficient is not 0, keeping at least one term
+        void trim() {
+            while(degree > 0 && coefficients[degree].get_value() == 0) degree--;
+        }
+    public:
+        GF64_fixed_poly() { degree = 0; }
+        GF64_fixed_poly(const GF64& constant) {
+            degree = 0;
+            coefficients[0] = constant;
+        }
+        // Reset the polynomial to 0
+        void clear() {
+            for(int i = 0; i <= degree; i++) coefficients[i] = GF64(0);
+            degree = 0;
+        }
+        // Set the coefficient of x^index (index < capacity)
+        void set_coefficients(int index, GF64 value) {
+            coefficients[index] = value;
+            if(index > degree) degree = index;
+            trim();
+        }
+        GF64 get_coefficient(int index) const {
+            if(index > degree) return GF64(0);
+            return coefficients[index];
+        }
+        int get_degree() const {
+            return degree;
+        }
+        bool is_zero() const {
+            return degree == 0 && coefficients[0].get_value() == 0;
+        }
+        // Add two polynomials
+        GF64_fixed_poly operator+(const GF64_fixed_poly& other) const {
+            GF64_fixed_poly result(*this);
+            for(int i = 0; i <= other.degree; i++) result.coefficients[i] = result.coefficients[i] + other.coefficients[i];
+            result.degree = std::max(degree, other.degree);
+            result.trim();
+            return result;
+        }
+        // Multiply two polynomials (the degrees must add up to less than the capacity)
+        GF64_fixed_poly operator*(const GF64_fixed_poly& other) const {
+            GF64_fixed_poly result;
+            for(int i = 0; i <= degree; i++) {
+                if(coefficients[i].get_value() == 0) continue;  // Skip zero terms
+                for(int j = 0; j <= other.degree; j++) {
+                    result.coefficients[i+j] = result.coefficients[i+j] + coefficients[i] * other.coefficients[j];
+                }
+            }
+            result.degree = degree + other.degree;
+            result.trim();
+            return result;
+        }
+        // Multiply a polynomial and a GF64 number
+        GF64_fixed_poly operator*(const GF64& other) const {
+            GF64_fixed_poly result;
+            for(int i = 0; i <= degree; i++) result.coefficients[i] = coefficients[i] * other;
+            result.degree = degree;
+            result.trim();
+            return result;
+        }
+        // Multiply by x^count (the degree must stay below the capacity)
+        GF64_fixed_poly shift(int count) const {
+            GF64_fixed_poly result;
+            if(is_zero()) return result;
+            for(int i = 0; i <= degree; i++) result.coefficients[i + count] = coefficients[i];
+            result.degree = degree + count;
+            return result;
+        }
+        // Divide by another polynomial, Y = X * Q + R
+        // Returns false (and leaves quotient and remainder untouched) if the divisor is 0
+        bool divide(const GF64_fixed_poly& divisor, GF64_fixed_poly& quotient, GF64_fixed_poly& remainder) const {
+            if(divisor.is_zero()) return false;
+            quotient.clear();
+            remainder = *this;
+            if(degree < divisor.degree) return true;
+            GF64 lead_inverse = divisor.coefficients[divisor.degree].inverse();
+            for(int i = degree; i >= divisor.degree; i--) {
+                // If the leading coefficient of the remainder is not 0
+                if(remainder.coefficients[i].get_value() == 0) continue;
+                GF64 coef = remainder.coefficients[i] * lead_inverse;
+                quotient.coefficients[i - divisor.degree] = coef;
+                for(int j = 0; j <= divisor.degree; j++) {
+                    remainder.coefficients[i - j] = remainder.coefficients[i - j] +
+                        divisor.coefficients[divisor.degree - j] * coef;
+                }
+            }
+            quotient.degree = degree - divisor.degree;
+            quotient.trim();
+            remainder.trim();
+            return true;
+        }
+        // Evaluate the polynomial at a given number (Horner's rule)
+        GF64 operator()(const GF64& x) const {
+            GF64 result(0);
+            for(int i = degree; i >= 0; i--) result = result * x + coefficients[i];
+            return result;
+        }
+        // Formal derivative, only the odd terms survive (1+1=0 in GF(64))
+        GF64_fixed_poly differentiate() const {
+            GF64_fixed_poly result;
+            for(int i = 1; i <= degree; i += 2) result.coefficients[i-1] = coefficients[i];
+            result.degree = degree > 0 ? degree - 1 : 0;
+            result.trim();
+            return result;
+        }
+        // Drop all the terms with degree greater than 20
+        GF64_fixed_poly mod_x21() const {
+            GF64_fixed_poly result(*this);
+            for(int i = 21; i <= degree; i++) result.coefficients[i] = GF64(0);
+            if(result.degree > 20) result.degree = 20;
+            result.trim();
+            return result;
+        }
+};
+
+#endif
@@ -0,0 +1,356 @@
+#ifndef RS_BITSLICED_H
+#define RS_BITSLICED_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+#include "gf64.h"
+#include "gf64_poly.h"
+#include "rs_decoder.h"
+
+// Bit-sliced GF(64) arithmetic: one GF64x64 holds one symbol of 64 frames at once.
+// Plane b holds bit b of the symbol, and bit f of every plane belongs to frame (lane) f.
+// Addition is 6 XORs, multiplication by a compile-time constant is a fixed XOR network,
+// and a general multiplication is a 6x6 AND/XOR schoolbook product reduced by x^6 = x + 1.
+struct GF64x64 {
+    uint64_t bit[6];
+
+    // The planes are written out one by one, so the values stay in registers at -O2
+    GF64x64() : bit{0, 0, 0, 0, 0, 0} {}
+    GF64x64(uint64_t b0, uint64_t b1, uint64_t b2, uint64_t b3, uint64_t b4, uint64_t b5)
+        : bit{b0, b1, b2, b3, b4, b5} {}
+    // Add two bit-sliced numbers
+    GF64x64 operator+(const GF64x64& other) const {
+        return GF64x64(bit[0] ^ other.bit[0], bit[1] ^ other.bit[1], bit[2] ^ other.bit[2],
+                       bit[3] ^ other.bit[3], bit[4] ^ other.bit[4], bit[5] ^ other.bit[5]);
+    }
+    // Multiply two bit-sliced numbers lane by lane
+    GF64x64 operator*(const GF64x64& other) const {
+        uint64_t product[11] = {0};
+        for(int i = 0; i < 6; i++) {
+            for(int j = 0; j < 6; j++) product[i + j] ^= bit[i] & other.bit[j];
+        }
+        // x^i = x^(i-5) + x^(i-6), from the highest term down
+        for(int i = 10; i >= 6; i--) {
+            product[i - 5] ^= product[i];
+            product[i - 6] ^= product[i];
+        }
+        GF64x64 result;
+        for(int b = 0; b < 6; b++) result.bit[b] = product[b];
+        return result;
+    }
+    // Lanes whose value is not 0
+    uint64_t nonzero() const {
+        return bit[0] | bit[1] | bit[2] | bit[3] | bit[4] | bit[5];
+    }
+    // Get the value of one lane
+    int get_lane(int lane) const {
+        int value = 0;
+        for(int b = 0; b < 6; b++) value |= ((bit[b] >> lane) & 1) << b;
+        return value;
+    }
+    // Set the value of one lane
+    void set_lane(int lane, int value) {
+        for(int b = 0; b < 6; b++) {
+            bit[b] = (bit[b] & ~(1ULL << lane)) | ((uint64_t)((value >> b) & 1) << lane);
+        }
+    }
+
+    // Multiply every lane by the constant C: output bit r is the XOR of the input bits s
+    // for which bit r of C * a^s is set, all the conditions are resolved at compile time
+    template<int C>
+    GF64x64 multiply_constant() const {
+        return multiply_constant<C>(std::make_integer_sequence<int, 6>());
+    }
+
+    private:
+        template<int C, int R, int... S>
+        uint64_t product_bit(std::integer_sequence<int, S...>) const {
+            return ((((mul_table[C][1 << S] >> R) & 1) ? bit[S] : 0) ^ ...);
+        }
+        template<int C, int... R>
+        GF64x64 multiply_constant(std::integer_sequence<int, R...>) const {
+            return GF64x64(product_bit<C, R>(std::make_integer_sequence<int, 6>())...);
+        }
+};
+
+// Decoder for groups of 64 frames with a bit-sliced Chien search
+// Every frame is copied and its syndromes computed with the shared SyndromeTableEngine as in
+// decode_frame, so clean frames (all syndromes 0) cost the same as in decode_batch. The erasure
+// locator, the erasure-only path and the key equation are data dependent and run per frame with
+// the ReedSolomonDecoder stages. When at least sliced_min_lanes frames of a group need the key
+// equation, their roots are searched for all at once on bit-sliced locators (one pass over the 63
+// positions for the whole group); a group with fewer corrupted frames decodes them with
+// correctFrame, where the per-frame Chien search or transform is cheaper than filling the
+// registers. The results are identical to ReedSolomonDecoder::decode_batch.
+class BitslicedDecoder {
+    private:
+        static const int n = RS63_42::n;
+        static const int max_locator_degree = 21;
+        // Corrupted frames per group from which the bit-sliced Chien search is used
+        static const int sliced_min_lanes = 8;
+        ReedSolomonDecoder decoder;
+        const SyndromeTableEngine& engine;
+        DecoderWorkspace ws;
+        // Syndrome bytes of every frame of the group (SyndromeTableEngine::compute layout)
+        alignas(32) uint8_t syndrome_values[64][32];
+        // Symbols of the group turned around bytewise: transposed[i][f] = symbol i of frame f
+        alignas(32) uint8_t transposed[63][64];
+        // Per-lane results of the key equation
+        uint8_t locators[64][max_locator_degree + 1];
+        GF64_fixed_poly evaluators[64];
+        int locator_degree[64];
+        int num_errors[64];
+        int error_positions[64][max_locator_degree];
+        GF64 error_values[64][max_locator_degree];
+        // The constant-time decoder loads its frames in bit-sliced form and computes the syndromes
+        // on them (the table engine's lookups depend on the data)
+        friend class ConstantTimeDecoder;
+
+        // Copy up to 64 frames to corrected with their erased symbols set to 0, and transpose them
+        // into bit-sliced symbols on the way
+        // The frames are first turned around bytewise (transposed[i][f] = symbol i of frame f), then
+        // plane b of symbol i is the sign bits of row i shifted left by 7 - b (one movemask per 16
+        // or 32 frames); without SSE2 the planes of 8 frames are gathered from one word with a multiply
+        void load_frames(const uint8_t* symbols, const uint64_t* erasure_masks, size_t count, size_t stride,
+                         uint8_t* corrected, GF64x64* received) {
+            // Blocks of 8 frames x 8 symbols are loaded as 8 words and swapped in 4x4, 2x2 and 1x1 blocks
+            for(size_t group = 0; group < 8; group++) {
+                size_t frames = group * 8 < count ? std::min<size_t>(8, count - group * 8) : 0;
+                for(int i = 0; i < n; i += 8) {
+                    // The last block has 7 symbols, do not read or write past the frame
+                    const int length = i + 8 <= n ? 8 : n - i;
+                    uint64_t w[8] = {0};
+                    for(size_t f = 0; f < frames; f++) {
+                        size_t frame = group * 8 + f;
+                        if(length == 8) memcpy(&w[f], symbols + frame * stride + i, 8);
+                        else memcpy(&w[f], symbols + frame * stride + i, n - i);
+                        // Byte k keeps bit k of the 8 erasure bits, a nonzero byte becomes 0xFF
+                        uint64_t erased = (((erasure_masks[frame] >> i) & 0xFF) * 0x0101010101010101ULL) &
+                                          0x8040201008040201ULL;
+                        erased = (((erased + 0x7F7F7F7F7F7F7F7FULL) | erased) & 0x8080808080808080ULL) >> 7;
+                        w[f] &= ~(erased * 0xFF) & 0x3F3F3F3F3F3F3F3FULL;
+                        if(length == 8) memcpy(corrected + frame * stride + i, &w[f], 8);
+                        else memcpy(corrected + frame * stride + i, &w[f], n - i);
+                    }
+                    for(int f = 0; f < 4; f++) {
+                        uint64_t swap = ((w[f] >> 32) ^ w[f + 4]) & 0x00000000FFFFFFFFULL;
+                        w[f] ^= swap << 32;
+                        w[f + 4] ^= swap;
+                    }
+                    for(int f : {0, 1, 4, 5}) {
+                        uint64_t swap = ((w[f] >> 16) ^ w[f + 2]) & 0x0000FFFF0000FFFFULL;
+                        w[f] ^= swap << 16;
+                        w[f + 2] ^= swap;
+                    }
+                    for(int f = 0; f < 8; f += 2) {
+                        uint64_t swap = ((w[f] >> 8) ^ w[f + 1]) & 0x00FF00FF00FF00FFULL;
+                        w[f] ^= swap << 8;
+                        w[f + 1] ^= swap;
+                    }
+                    for(int j = 0; j < 8 && i + j < n; j++) memcpy(&transposed[i + j][8 * group], &w[j], 8);
+                }
+            }
+            for(int i = 0; i < n; i++) {
+                received[i] = GF64x64();
+#if defined(__AVX2__)
+                for(int half = 0; half < 2; half++) {
+                    __m256i row = _mm256_load_si256((const __m256i*)&transposed[i][32 * half]);
+                    for(int b = 0; b < 6; b++) {
+                        uint64_t bits = (uint32_t)_mm256_movemask_epi8(_mm256_slli_epi64(row, 7 - b));
+                        received[i].bit[b] |= bits << (32 * half);
+                    }
+                }
+#elif defined(__SSE2__)
+                for(int quarter = 0; quarter < 4; quarter++) {
+                    __m128i row = _mm_load_si128((const __m128i*)&transposed[i][16 * quarter]);
+                    for(int b = 0; b < 6; b++) {
+                        uint64_t bits = (uint16_t)_mm_movemask_epi8(_mm_slli_epi64(row, 7 - b));
+                        received[i].bit[b] |= bits << (16 * quarter);
+                    }
+                }
+#else
+                for(int group = 0; group < 8; group++) {
+                    uint64_t packed;
+                    memcpy(&packed, &transposed[i][8 * group], 8);
+                    // Gather bit b of the 8 bytes into the top byte, keeping the frame order
+                    for(int b = 0; b < 6; b++) {
+                        uint64_t bits = (((packed >> b) & 0x0101010101010101ULL) * 0x0102040810204080ULL) >> 56;
+                        received[i].bit[b] |= bits << (8 * group);
+                    }
+                }
+#endif
+            }
+        }
+
+        // S_j = r(a^j) by Horner's rule with the constant a^j, j = 1~21
+        template<int J>
+        static GF64x64 syndrome(const GF64x64* received) {
+            GF64x64 value = received[n - 1];
+            for(int i = n - 2; i >= 0; i--) {
+                value = value.multiply_constant<pow_table[J % 63]>() + received[i];
+            }
+            return value;
+        }
+        template<int... J>
+        static void syndromes(const GF64x64* received, GF64x64* result, std::integer_sequence<int, J...>) {
+            ((result[J] = syndrome<J + 1>(received)), ...);
+        }
+
+        // Move Chien register j to the next position (multiply by a^(-j)) if j <= degree
+        template<int... J>
+        static void chien_step(GF64x64* registers, int degree, std::integer_sequence<int, J...>) {
+            ((J + 1 <= degree ? (void)(registers[J + 1] = registers[J + 1].template multiply_constant<pow_table[(63 - J - 1) % 63]>())
+                              : (void)0), ...);
+        }
+
+        // Bit-sliced Chien search over the given lanes, fills error_positions, error_values and num_errors
+        void chienSearch(uint64_t lanes) {
+            GF64x64 registers[max_locator_degree + 1];
+            int degree = 0;
+            for(int lane = 0; lane < 64; lane++) {
+                if(!((lanes >> lane) & 1)) continue;
+                num_errors[lane] = 0;
+                degree = std::max(degree, locator_degree[lane]);
+            }
+            // Register j holds lambda_j * X^j of every lane
+            for(int lane = 0; lane < 64; lane++) {
+                if(!((lanes >> lane) & 1)) continue;
+                for(int j = 0; j <= locator_degree[lane]; j++) {
+                    registers[j].set_lane(lane, locators[lane][j]);
+                }
+            }
+            // A locator of degree 0 has no roots to look for
+            uint64_t searching = 0;
+            for(int lane = 0; lane < 64; lane++) {
+                if(((lanes >> lane) & 1) && locator_degree[lane] > 0) searching |= 1ULL << lane;
+            }
+            for(int i = 0; i < n && searching != 0; i++) {
+                GF64x64 even, odd;
+                for(int j = 0; j <= degree; j += 2) even = even + registers[j];
+                for(int j = 1; j <= degree; j += 2) odd = odd + registers[j];
+                // Lambda(X) = even + odd = 0 and X * Lambda'(X) = odd != 0
+                uint64_t roots = ~(even + odd).nonzero() & odd.nonzero() & searching;
+                while(roots != 0) {
+                    int lane = __builtin_ctzll(roots);
+                    roots &= roots - 1;
+                    // omega(X) / Lambda'(X) = X * omega(X) / (X * Lambda'(X))
+                    GF64 X(pow_table[(63 - i) % 63]);
+                    int e = num_errors[lane]++;
+                    error_positions[lane][e] = i;
+                    error_values[lane][e] = evaluators[lane](X) * X * GF64(odd.get_lane(lane)).inverse();
+                    if(num_errors[lane] == locator_degree[lane]) searching &= ~(1ULL << lane);
+                }
+                chien_step(registers, degree, std::make_integer_sequence<int, max_locator_degree>());
+            }
+        }
+
+    public:
+        BitslicedDecoder(KeyEquationSolver solver = RS_KEY_EQUATION_SOLVER)
+            : decoder(solver), engine(SyndromeTableEngine::instance()) {}
+
+        // Decode up to 64 frames, same layout and results as ReedSolomonDecoder::decode_batch
+        void decode_group(const uint8_t* symbols, const uint64_t* erasure_masks, size_t count,
+                          uint8_t* corrected, uint8_t* status, size_t stride) {
+            // Copy the frames with their erased symbols set to 0 and compute their syndromes
+            uint64_t dirty = 0;
+            for(size_t f = 0; f < count; f++) {
+                const uint8_t* in = symbols + f * stride;
+                uint8_t* out = corrected + f * stride;
+                uint64_t mask = erasure_masks[f] & ((1ULL << n) - 1);
+                uint8_t invalid = 0;
+                for(int i = 0; i < n; i++) {
+                    uint8_t symbol = ((mask >> i) & 1) ? 0 : in[i];
+                    invalid |= symbol;
+                    out[i] = symbol & 63;
+                }
+                if(invalid & ~63) {
+                    status[f] = DECODE_MALFORMED;
+                    continue;
+                }
+                engine.compute(out, syndrome_values[f]);
+                uint64_t words[3];
+                memcpy(words, syndrome_values[f], 24);
+                if((words[0] | words[1] | words[2]) == 0) {
+                    status[f] = DECODE_OK;
+                    continue;
+                }
+                if(__builtin_popcountll(mask) > 21) {
+                    status[f] = DECODE_TOO_MANY_ERASURES;
+                    continue;
+                }
+                dirty |= 1ULL << f;
+            }
+            if(dirty == 0) return;
+
+            bool sliced = __builtin_popcountll(dirty) >= sliced_min_lanes;
+            uint64_t chien_lanes = 0;
+            for(uint64_t lanes = dirty; lanes != 0; lanes &= lanes - 1) {
+                int f = __builtin_ctzll(lanes);
+                uint8_t* out = corrected + f * stride;
+                uint64_t mask = erasure_masks[f] & ((1ULL << n) - 1);
+                decoder.loadSyndromes(syndrome_values[f], ws.syndromes);
+                decoder.calculateErasureLocator(mask, ws.erasure_locator);
+                decoder.calculateForneySyndromes(ws);
+                if(!sliced) {
+                    status[f] = decoder.correctFrame(mask, out, ws);
+                    continue;
+                }
+                // Erasure-only frames and the checks before the search, as in correctFrame
+                bool correctable = mask != 0 && decoder.correctErasures(mask, ws);
+                if(!correctable) {
+                    if(decoder.key_equation_solver == KEY_EQUATION_BERLEKAMP_MASSEY) decoder.berlekampMasseyAlgorithm(ws);
+                    else decoder.euclideanAlgorithm(ws);
+                    int degree = ws.locator.get_degree();
+                    if(degree <= max_locator_degree && ws.locator.get_coefficient(0).get_value() != 0 &&
+                       ws.evaluator.get_degree() < degree) {
+                        // Searched with the other lanes below
+                        locator_degree[f] = degree;
+                        for(int j = 0; j <= degree; j++) locators[f][j] = ws.locator.get_coefficient(j).get_value();
+                        evaluators[f] = ws.evaluator;
+                        chien_lanes |= 1ULL << f;
+                        continue;
+                    }
+                    // Rejected, or beyond the register file: the scalar stage decides
+                    correctable = decoder.correctErrors(ws);
+                }
+                for(int e = 0; correctable && e < ws.num_errors; e++) {
+                    out[ws.error_positions[e]] ^= ws.error_values[e].get_value();
+                }
+                status[f] = correctable ? DECODE_CORRECTED : DECODE_UNCORRECTABLE;
+            }
+            if(chien_lanes == 0) return;
+
+            chienSearch(chien_lanes);
+            for(int lane = 0; lane < 64; lane++) {
+                if(!((chien_lanes >> lane) & 1)) continue;
+                if(num_errors[lane] != locator_degree[lane]) {
+                    status[lane] = DECODE_UNCORRECTABLE;
+                    continue;
+                }
+                uint8_t* out = corrected + lane * stride;
+                for(int e = 0; e < num_errors[lane]; e++) out[error_positions[lane][e]] ^= error_values[lane][e].get_value();
+                status[lane] = DECODE_CORRECTED;
+            }
+        }
+
+        // Decode count frames in groups of 64, same layout and results as ReedSolomonDecoder::decode_batch
+        void decode_batch(const uint8_t* symbols, const uint64_t* erasure_masks, size_t count,
+                          uint8_t* corrected, uint8_t* status, size_t stride = CodewordBatch::stride) {
+            for(size_t first = 0; first < count; first += 64) {
+                size_t group = std::min<size_t>(64, count - first);
+                decode_group(symbols + first * stride, erasure_masks + first, group,
+                             corrected + first * stride, status + first, stride);
+            }
+        }
+
+        void decode_batch(CodewordBatch& batch) {
+            decode_batch(batch.symbols, batch.erasure_masks, batch.count, batch.corrected, batch.status);
+        }
+};
+
+#endif
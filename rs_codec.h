@@ -0,0 +1,420 @@
+#ifndef RS_CODEC_H
+#define RS_CODEC_H
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include "gf64.h"
+
+// Compile-time parameterized Reed-Solomon codec
+// GaloisField<M, Primitive> is GF(2^M) built from a primitive polynomial, and
+// RSCodec<Field, N, K, FirstRoot> is the RS(N, K) code over it whose generator polynomial has the
+// roots a^FirstRoot ~ a^(FirstRoot + N - K - 1). The tables and the generator polynomial are
+// generated at compile time and every inner loop runs over a compile-time number of symbols.
+// N may be smaller than 2^M - 1 (a shortened code): the missing symbols are zeros that are
+// never stored, sent or visited.
+// The (63, 42) code of this project is RS63_42; the hand-written decoder and encoders take their
+// parameters and generator polynomial from it.
+
+// Result of decoding one frame
+// Every decoder reports its failures with these values: nothing on the decode path exits,
+// aborts or throws, so one bad frame never takes down a batch or a worker.
+enum DecodeStatus : uint8_t {
+    DECODE_OK = 0,                 // All syndromes are zero, the frame is passed through
+    DECODE_CORRECTED = 1,          // Errors and/or erasures were found and corrected
+    DECODE_TOO_MANY_ERASURES = 2,  // More than N - K erasures, the frame is passed through
+    DECODE_UNCORRECTABLE = 3,      // The decoder gave up, the frame is passed through
+    DECODE_MALFORMED = 4           // Not a frame (a symbol out of the field, a bad length or erasure
+                                   // index), checked first; the frame is passed through
+};
+const int decode_status_count = 5;
+
+// Name of a status for messages and statistics
+inline const char* decode_status_name(DecodeStatus status) {
+    static const char* const names[decode_status_count] = {"ok", "corrected", "too many erasures", "uncorrectable",
+                                                           "malformed"};
+    return (int)status < decode_status_count ? names[status] : "unknown";
+}
+
+template<int M, unsigned Primitive>
+struct GaloisField {
+    static_assert(M >= 2 && M <= 12, "GaloisField supports GF(2^2) ~ GF(2^12)");
+    static_assert((Primitive >> M) == 1, "the primitive polynomial must have degree M");
+    using symbol = typename std::conditional<(M <= 8), uint8_t, uint16_t>::type;
+    static const int bits = M;
+    static const int size = 1 << M;
+    static const int order = size - 1;   // Multiplicative order of a
+
+    struct Tables {
+        std::array<symbol, 2 * order> pow{};   // pow[i] = a^i, twice, so log(x) + log(y) needs no modulo
+        std::array<int, size> log{};           // log[a^i] = i (log[0] is unused and set to 0)
+        bool primitive = true;                 // a generates every nonzero element
+    };
+    static constexpr Tables make_tables() {
+        Tables tables;
+        unsigned value = 1;
+        for(int i = 0; i < order; i++) {
+            if(value == 1 && i > 0) tables.primitive = false;
+            tables.pow[i] = tables.pow[i + order] = (symbol)value;
+            tables.log[value] = i;
+            value <<= 1;
+            if(value & size) value ^= Primitive;
+        }
+        return tables;
+    }
+    static constexpr Tables tables = make_tables();
+    static_assert(tables.primitive, "the polynomial is not primitive");
+
+    // Full product table for the small fields (4 KB for GF(64)), log/exp lookups otherwise
+    static const bool has_mul_table = M <= 6;
+    static constexpr std::array<std::array<symbol, has_mul_table ? size : 1>, has_mul_table ? size : 1> make_mul_table() {
+        std::array<std::array<symbol, has_mul_table ? size : 1>, has_mul_table ? size : 1> table{};
+        if(has_mul_table) {
+            for(int x = 1; x < size; x++) {
+                for(int y = 1; y < size; y++) table[x][y] = tables.pow[tables.log[x] + tables.log[y]];
+            }
+        }
+        return table;
+    }
+    static constexpr auto mul_table = make_mul_table();
+
+    // a^i for any integer i
+    static constexpr symbol pow(int i) {
+        i %= order;
+        return tables.pow[i < 0 ? i + order : i];
+    }
+    static constexpr symbol mul(symbol x, symbol y) {
+        if constexpr(has_mul_table) return mul_table[x][y];
+        else return (x == 0 || y == 0) ? 0 : tables.pow[tables.log[x] + tables.log[y]];
+    }
+    // 1 / x (the inverse of 0 is returned as 0)
+    static constexpr symbol inv(symbol x) {
+        return x == 0 ? 0 : tables.pow[order - tables.log[x]];
+    }
+};
+
+template<typename Field, int N, int K, int FirstRoot = 1>
+class RSCodec {
+    public:
+        using field = Field;
+        using symbol = typename Field::symbol;
+        static const int n = N;                 // Code length
+        static const int k = K;                 // Message length
+        static const int parity = N - K;        // Parity symbols, also the number of syndromes
+        static const int t = parity / 2;        // Error correction capability
+        static const int first_root = FirstRoot;
+        static const int shortening = Field::order - N;
+        static_assert(0 < K && K < N && N <= Field::order, "RSCodec needs 0 < K < N <= 2^M - 1");
+
+        // Generator polynomial g(x) = (x + a^b)(x + a^(b+1)) ... (x + a^(b+N-K-1)), lowest degree first
+        static constexpr std::array<symbol, parity + 1> make_generator() {
+            std::array<symbol, parity + 1> g{};
+            g[0] = 1;
+            for(int j = 0; j < parity; j++) {
+                symbol root = Field::pow(FirstRoot + j);
+                // g(x) = g(x) * (x + root)
+                for(int i = j + 1; i > 0; i--) g[i] = g[i - 1] ^ Field::mul(g[i], root);
+                g[0] = Field::mul(g[0], root);
+            }
+            return g;
+        }
+        static constexpr std::array<symbol, parity + 1> generator = make_generator();
+
+        // Exponent of the locator of stored symbol i: the message symbols are positions 0 ~ K-1 of
+        // the full-length code and the parity symbols follow the shortened (always zero) positions
+        static constexpr int position(int i) {
+            return i < K ? i : i + shortening;
+        }
+
+        // Systematic encoding: codeword = K message symbols followed by N - K parity symbols
+        // The shift register computes x^(N-K) * m(x) mod g(x) of the full-length code; the code is
+        // cyclic, so rotating it puts the message first and the parity after the shortened zeros
+        static void encode(const symbol* message, symbol* codeword) {
+            symbol reg[parity] = {0};
+            for(int i = K - 1; i >= 0; i--) {
+                symbol feedback = message[i] ^ reg[parity - 1];
+                for(int j = parity - 1; j > 0; j--) reg[j] = reg[j - 1] ^ Field::mul(feedback, generator[j]);
+                reg[0] = Field::mul(feedback, generator[0]);
+            }
+            for(int i = 0; i < K; i++) codeword[i] = message[i];
+            for(int j = 0; j < parity; j++) codeword[K + j] = reg[j];
+        }
+
+        // S_j = r(a^(b+j)), j = 0 ~ N-K-1
+        // Small fields add up one table row per stored symbol (as 64-bit words, the rows are bytes),
+        // the others use Horner's rule over the stored symbols (highest first); the N - K chains
+        // are independent, so the lookups of one symbol overlap
+        // Returns whether any syndrome is nonzero
+        static bool syndromes(const symbol* received, symbol* S) {
+            if constexpr(table_driven) {
+                // Two accumulators halve the dependency chain of the XORs
+                uint64_t sum[syndrome_stride / 8] = {0}, odd_sum[syndrome_stride / 8] = {0}, any = 0;
+                for(int i = 0; i + 1 < N; i += 2) {
+                    add_row(sum, syndrome_rows[i][received[i] & Field::order].data());
+                    add_row(odd_sum, syndrome_rows[i + 1][received[i + 1] & Field::order].data());
+                }
+                if(N & 1) add_row(sum, syndrome_rows[N - 1][received[N - 1] & Field::order].data());
+                for(int w = 0; w < syndrome_stride / 8; w++) {
+                    sum[w] ^= odd_sum[w];
+                    any |= sum[w];
+                }
+                // Byte by byte (copying the words out would keep sum in memory through the loop)
+                for(int j = 0; j < parity; j++) S[j] = any == 0 ? 0 : (symbol)(sum[j / 8] >> (8 * (j % 8)));
+                return any != 0;
+            }
+            for(int j = 0; j < parity; j++) S[j] = 0;
+            for(int i = N - 1; i >= K; i--) {
+                for(int j = 0; j < parity; j++) S[j] = Field::mul(S[j], root_powers[0][j]) ^ received[i];
+            }
+            // Step over the shortened zeros between the message and the parity
+            if(shortening > 0) {
+                for(int j = 0; j < parity; j++) S[j] = Field::mul(S[j], root_powers[1][j]);
+            }
+            for(int i = K - 1; i >= 0; i--) {
+                for(int j = 0; j < parity; j++) S[j] = Field::mul(S[j], root_powers[0][j]) ^ received[i];
+            }
+            symbol any = 0;
+            for(int j = 0; j < parity; j++) any |= S[j];
+            return any != 0;
+        }
+
+        // Decode one frame with the erasures given as a list of symbol indices
+        // received and codeword hold N symbols; a frame that cannot be decoded is copied through
+        // with its erased symbols set to 0. An erasure index outside 0 ~ N-1, or a symbol above
+        // the field at a position that is not erased, makes the frame MALFORMED.
+        static DecodeStatus decode(const symbol* received, const int* erasures, int num_erasures, symbol* codeword) {
+            bool malformed = num_erasures < 0;
+            for(int i = 0; i < N; i++) codeword[i] = received[i];
+            for(int e = 0; e < num_erasures; e++) {
+                if(erasures[e] < 0 || erasures[e] >= N) malformed = true;
+                else codeword[erasures[e]] = 0;
+            }
+            symbol invalid = 0;
+            for(int i = 0; i < N; i++) {
+                invalid |= codeword[i] & ~Field::order;
+                codeword[i] &= Field::order;
+            }
+            if(malformed || invalid != 0) return DECODE_MALFORMED;
+            symbol S[parity];
+            if(!syndromes(codeword, S)) return DECODE_OK;
+            return correct(codeword, S, erasures, num_erasures);
+        }
+
+        // Decode with the erasures as a bit mask (bit i marks symbol i), for N <= 64
+        // The copy, the erasures and the range check are one pass, like decode_frame
+        static DecodeStatus decode(const symbol* received, uint64_t erasure_mask, symbol* codeword) {
+            static_assert(N <= 64, "erasure masks need N <= 64");
+            if(N < 64) erasure_mask &= (1ULL << (N & 63)) - 1;
+            symbol invalid = 0;
+            for(int i = 0; i < N; i++) {
+                symbol value = ((erasure_mask >> i) & 1) ? 0 : received[i];
+                invalid |= value;
+                codeword[i] = value & Field::order;
+            }
+            if(invalid & ~Field::order) return DECODE_MALFORMED;
+            symbol S[parity];
+            if(!syndromes(codeword, S)) return DECODE_OK;
+            int erasures[64], num_erasures = 0;
+            for(; erasure_mask != 0; erasure_mask &= erasure_mask - 1) erasures[num_erasures++] = __builtin_ctzll(erasure_mask);
+            return correct(codeword, S, erasures, num_erasures);
+        }
+
+    private:
+        // sum ^= one table row (syndrome_stride or chien_stride bytes), 64 bits at a time
+        template<size_t Words>
+        static void add_row(uint64_t (&sum)[Words], const symbol* row) {
+            for(size_t w = 0; w < Words; w++) {
+                uint64_t word;
+                memcpy(&word, row + 8 * w, 8);
+                sum[w] ^= word;
+            }
+        }
+
+        // Everything after the syndromes: codeword holds N valid symbols with the erasures set to 0,
+        // and S its syndromes (not all zero)
+        static DecodeStatus correct(symbol* codeword, const symbol* S, const int* erasures, int num_erasures) {
+            if(num_erasures > parity) return DECODE_TOO_MANY_ERASURES;
+
+            // Errors-and-erasures Berlekamp-Massey started from Gamma(x) = prod(1 + X_e x)
+            // B(x) is kept as x^b_shift * b(x), so multiplying it by x is free and every step only
+            // touches the deg(b) + 1 coefficients of b(x) and the L + 1 of Lambda(x) (as in
+            // ReedSolomonDecoder::berlekampMasseyAlgorithm)
+            symbol lambda[parity + 1] = {1}, b[parity + 1] = {0}, old[parity + 1];
+            for(int e = 0; e < num_erasures; e++) {
+                symbol X = Field::pow(position(erasures[e]));
+                for(int j = e + 1; j > 0; j--) lambda[j] ^= Field::mul(lambda[j - 1], X);
+            }
+            int L = num_erasures, b_degree = num_erasures, b_shift = 0;
+            for(int j = 0; j <= L; j++) b[j] = lambda[j];
+            bool overflow = false;
+            for(int r = num_erasures; r < parity; r++) {
+                // Discrepancy of step r + 1: sum(Lambda_j * S_(r-j)), deg(Lambda) <= L
+                symbol delta = 0;
+                for(int j = 0; j <= L && j <= r; j++) delta ^= Field::mul(lambda[j], S[r - j]);
+                if(delta == 0) {
+                    b_shift++;
+                    continue;
+                }
+                bool length_change = 2 * L <= r + num_erasures;
+                if(length_change) {
+                    for(int j = 0; j <= L; j++) old[j] = lambda[j];
+                }
+                // Lambda(x) = Lambda(x) + delta * x * B(x), a term past x^(N-K) cannot be corrected
+                for(int j = 0; j <= b_degree; j++) {
+                    int index = j + b_shift + 1;
+                    if(index <= parity) lambda[index] ^= Field::mul(delta, b[j]);
+                    else if(b[j] != 0) overflow = true;
+                }
+                if(length_change) {
+                    // B(x) = old Lambda(x) / delta
+                    symbol delta_inverse = Field::inv(delta);
+                    for(int j = 0; j <= L; j++) b[j] = Field::mul(old[j], delta_inverse);
+                    b_degree = L;
+                    b_shift = 0;
+                    L = r + 1 + num_erasures - L;
+                }
+                else b_shift++;
+            }
+            int degree = 0;
+            for(int j = 0; j <= parity; j++) {
+                if(lambda[j] != 0) degree = j;
+            }
+            // The errors must fit in the redundancy ( 2 * (L - e_0) + e_0 <= N - K )
+            if(overflow || degree != L || 2 * L - num_erasures > parity) return DECODE_UNCORRECTABLE;
+            // omega(x) = Lambda(x) * S(x) mod x^(N-K), deg(omega) < deg(Lambda)
+            symbol omega[parity];
+            for(int i = 0; i < parity; i++) {
+                symbol value = 0;
+                for(int j = 0; j <= i && j <= degree; j++) value ^= Field::mul(lambda[j], S[i - j]);
+                omega[i] = value;
+                if(value != 0 && i >= degree) return DECODE_UNCORRECTABLE;
+            }
+
+            int error_positions[parity];
+            symbol error_values[parity];
+            int found = 0;
+            if constexpr(table_driven) {
+                // Chien search and Forney over all positions at once: Lambda(X^-1) split into its
+                // even and odd terms, and omega(X^-1), are sums of table rows (one per coefficient)
+                uint64_t even_words[chien_stride / 8] = {0}, odd_words[chien_stride / 8] = {0},
+                         omega_words[chien_stride / 8] = {0};
+                for(int j = 0; j <= degree; j++) add_row((j & 1) ? odd_words : even_words, chien_rows[j][lambda[j]].data());
+                for(int j = 0; j < degree; j++) add_row(omega_words, chien_rows[j][omega[j]].data());
+                symbol even[chien_stride], odd[chien_stride], omega_values[chien_stride];
+                memcpy(even, even_words, chien_stride);
+                memcpy(odd, odd_words, chien_stride);
+                memcpy(omega_values, omega_words, chien_stride);
+                for(int i = 0; i < N; i++) {
+                    if(even[i] == odd[i] && odd[i] != 0 && found < parity) {
+                        // Forney: e = X^(-b) * omega(X^(-1)) / (X^(-1) * Lambda'(X^(-1))), X = a^position
+                        error_positions[found] = i;
+                        error_values[found] = Field::mul(Field::mul(omega_values[i], Field::pow(-position(i) * FirstRoot)),
+                                                         Field::inv(odd[i]));
+                        found++;
+                    }
+                }
+            } else {
+                // Chien search over the stored symbols: register j holds Lambda_j * X^(-j)
+                symbol reg[parity + 1];
+                for(int j = 0; j <= parity; j++) reg[j] = lambda[j];
+                for(int i = 0; i < N; i++) {
+                    if(i == K && shortening > 0) {
+                        // Jump over the shortened positions
+                        for(int j = 1; j <= degree; j++) reg[j] = Field::mul(reg[j], chien_steps[1][j]);
+                    }
+                    symbol even = 0, odd = 0;
+                    for(int j = 0; j <= degree; j += 2) even ^= reg[j];
+                    for(int j = 1; j <= degree; j += 2) odd ^= reg[j];
+                    if(even == odd && odd != 0 && found < parity) {
+                        // Forney: e = X^(-b) * omega(X^(-1)) / (X^(-1) * Lambda'(X^(-1))), X = a^position
+                        int p = position(i);
+                        symbol X_inverse = Field::pow(-p), omega_value = 0;
+                        for(int j = degree - 1; j >= 0; j--) omega_value = Field::mul(omega_value, X_inverse) ^ omega[j];
+                        error_positions[found] = i;
+                        error_values[found] = Field::mul(Field::mul(omega_value, Field::pow(-p * FirstRoot)), Field::inv(odd));
+                        found++;
+                    }
+                    for(int j = 1; j <= degree; j++) reg[j] = Field::mul(reg[j], chien_steps[0][j]);
+                }
+            }
+            if(found != degree) return DECODE_UNCORRECTABLE;
+            for(int e = 0; e < found; e++) codeword[error_positions[e]] ^= error_values[e];
+            return DECODE_CORRECTED;
+        }
+
+        // Small fields (the product table of GF(64) and below) use position tables:
+        // syndrome_rows[i][v][j] = v * a^((b+j) * position(i)), chien_rows[j][v][i] = v * a^(-j * position(i)),
+        // rows padded to multiples of 32 symbols (GF(64) RS(63, 42): 129 KB and 90 KB)
+        static const bool table_driven = Field::has_mul_table;
+        static const int syndrome_stride = (parity + 31) / 32 * 32;
+        static const int chien_stride = (N + 31) / 32 * 32;
+        static const int table_positions = table_driven ? N : 1;
+        static const int table_values = table_driven ? Field::size : 1;
+        using SyndromeRows = std::array<std::array<std::array<symbol, syndrome_stride>, table_values>, table_positions>;
+        using ChienRows = std::array<std::array<std::array<symbol, chien_stride>, table_values>, table_driven ? parity + 1 : 1>;
+        static constexpr SyndromeRows make_syndrome_rows() {
+            SyndromeRows rows{};
+            if(table_driven) {
+                for(int i = 0; i < N; i++) {
+                    for(int j = 0; j < parity; j++) {
+                        symbol root = Field::pow((FirstRoot + j) * position(i));
+                        for(int v = 1; v < Field::size; v++) rows[i][v][j] = Field::mul((symbol)v, root);
+                    }
+                }
+            }
+            return rows;
+        }
+        static constexpr ChienRows make_chien_rows() {
+            ChienRows rows{};
+            if(table_driven) {
+                for(int j = 0; j <= parity; j++) {
+                    for(int i = 0; i < N; i++) {
+                        symbol step = Field::pow(-j * position(i));
+                        for(int v = 1; v < Field::size; v++) rows[j][v][i] = Field::mul((symbol)v, step);
+                    }
+                }
+            }
+            return rows;
+        }
+        alignas(64) static constexpr SyndromeRows syndrome_rows = make_syndrome_rows();
+        alignas(64) static constexpr ChienRows chien_rows = make_chien_rows();
+
+        // root_powers[0][j] = a^(b+j) steps one position, root_powers[1][j] = a^((b+j) * shortening)
+        // adds the shortened gap
+        static constexpr std::array<std::array<symbol, parity>, 2> make_root_powers() {
+            std::array<std::array<symbol, parity>, 2> powers{};
+            for(int j = 0; j < parity; j++) {
+                powers[0][j] = Field::pow(FirstRoot + j);
+                powers[1][j] = Field::pow((FirstRoot + j) * shortening);
+            }
+            return powers;
+        }
+        static constexpr std::array<std::array<symbol, parity>, 2> root_powers = make_root_powers();
+        // chien_steps[0][j] = a^(-j) moves register j to the next position, chien_steps[1][j] =
+        // a^(-j * shortening) over the shortened gap
+        static constexpr std::array<std::array<symbol, parity + 1>, 2> make_chien_steps() {
+            std::array<std::array<symbol, parity + 1>, 2> steps{};
+            for(int j = 0; j <= parity; j++) {
+                steps[0][j] = Field::pow(-j);
+                steps[1][j] = Field::pow(-j * shortening);
+            }
+            return steps;
+        }
+        static constexpr std::array<std::array<symbol, parity + 1>, 2> chien_steps = make_chien_steps();
+};
+
+// The (63, 42) code of this project: GF(64) from x^6 + x + 1, roots a^1 ~ a^21
+using GF64Field = GaloisField<6, gf64_primitive_poly>;
+using RS63_42 = RSCodec<GF64Field, 63, 42, 1>;
+
+// The GF64 tables of gf64.h are the same field
+constexpr bool gf64_tables_match() {
+    for(int i = 0; i < 63; i++) {
+        if(pow_table[i] != GF64Field::pow(i)) return false;
+    }
+    return true;
+}
+static_assert(gf64_tables_match(), "gf64.h and GF64Field disagree");
+
+#endif
@@ -0,0 +1,377 @@
+#ifndef RS_CONSTANT_TIME_H
+#define RS_CONSTANT_TIME_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include "gf64.h"
+#include "rs_decoder.h"
+#include "rs_bitsliced.h"
+
+// Constant-time decoding: every frame runs the same operations, whatever its error pattern
+// The stages of ReedSolomonDecoder stop early, skip work and divide depending on the data, so
+// their latency spreads with the error weight. Here:
+//  - the key equation is an inversionless Berlekamp-Massey with exactly 21 iterations: the
+//    erasures take the first iterations (Lambda(x) is multiplied by (1 + X_r x) and B(x) set to
+//    the product, with the erasure locators packed into 21 slots and X_r = 0 for the unused ones), and every
+//    other iteration is an update Lambda = gamma * Lambda + delta * x * B with no division.
+//    The length L is tracked as D = r + e - 2L (D >= 0 is the length change test, a length
+//    change turns D into -D - 1 = ~D), so no erasure count is needed during the iterations.
+//  - the Chien search and Forney run over all 63 positions and all coefficients (the 63
+//    denominators share one inversion), the error values are masked by the root test, and the checks of the scalar decoder are evaluated
+//    as masks at the end and applied with one select per symbol.
+// Every decision is a mask, so the same kernel runs on one frame (GF64x1, masks are 0 or ~0)
+// and on 64 bit-sliced frames at once (GF64x64, bit f of a mask is lane f). The results are
+// identical to ReedSolomonDecoder::decode_frame.
+
+// One frame in the lane interface of GF64x64 (a mask is 0 or all ones)
+struct GF64x1 {
+    uint8_t value;
+
+    GF64x1() : value(0) {}
+    explicit GF64x1(uint8_t value) : value(value) {}
+    GF64x1 operator+(const GF64x1& other) const { return GF64x1(value ^ other.value); }
+    GF64x1 operator*(const GF64x1& other) const { return GF64x1(mul_table[value][other.value]); }
+    uint64_t nonzero() const { return 0 - (uint64_t)(value != 0); }
+    template<int C>
+    GF64x1 multiply_constant() const { return GF64x1(mul_table[C][value]); }
+};
+
+// Small signed integer of every lane (two's complement, -128 ~ 127)
+// CounterX1 is one lane, Counter64 holds 64 lanes bit-sliced in 8 planes
+struct CounterX1 {
+    int value;
+
+    explicit CounterX1(int value = 0) : value(value) {}
+    CounterX1 operator+(const CounterX1& other) const { return CounterX1(value + other.value); }
+    CounterX1 operator-(const CounterX1& other) const { return CounterX1(value - other.value); }
+    CounterX1 operator~() const { return CounterX1(~value); }
+    // Add 1 in the lanes of mask
+    CounterX1 increment(uint64_t mask) const { return CounterX1(value + (int)(mask & 1)); }
+    uint64_t negative() const { return 0 - (uint64_t)(value < 0); }
+    uint64_t equals(const CounterX1& other) const { return 0 - (uint64_t)(value == other.value); }
+    static CounterX1 select(uint64_t mask, const CounterX1& a, const CounterX1& b) {
+        return CounterX1((int)(((unsigned)a.value & (unsigned)mask) | ((unsigned)b.value & ~(unsigned)mask)));
+    }
+};
+
+struct Counter64 {
+    uint64_t bit[8];
+
+    explicit Counter64(int value = 0) {
+        for(int b = 0; b < 8; b++) bit[b] = 0 - (uint64_t)((value >> b) & 1);
+    }
+    // Ripple-carry addition of every lane
+    Counter64 add(const Counter64& other, uint64_t carry) const {
+        Counter64 sum;
+        for(int b = 0; b < 8; b++) {
+            uint64_t x = bit[b] ^ other.bit[b];
+            sum.bit[b] = x ^ carry;
+            carry = (bit[b] & other.bit[b]) | (carry & x);
+        }
+        return sum;
+    }
+    Counter64 operator+(const Counter64& other) const { return add(other, 0); }
+    Counter64 operator-(const Counter64& other) const { return add(~other, ~0ULL); }
+    Counter64 operator~() const {
+        Counter64 result;
+        for(int b = 0; b < 8; b++) result.bit[b] = ~bit[b];
+        return result;
+    }
+    Counter64 increment(uint64_t mask) const { return add(Counter64(0), mask); }
+    uint64_t negative() const { return bit[7]; }
+    uint64_t equals(const Counter64& other) const {
+        uint64_t differ = 0;
+        for(int b = 0; b < 8; b++) differ |= bit[b] ^ other.bit[b];
+        return ~differ;
+    }
+    static Counter64 select(uint64_t mask, const Counter64& a, const Counter64& b) {
+        Counter64 result;
+        for(int p = 0; p < 8; p++) result.bit[p] = (a.bit[p] & mask) | (b.bit[p] & ~mask);
+        return result;
+    }
+};
+
+// What the kernel needs besides the arithmetic of a lane type
+template<typename Lane> struct LaneTraits;
+
+template<> struct LaneTraits<GF64x1> {
+    using Counter = CounterX1;
+    static GF64x1 broadcast(uint8_t value) { return GF64x1(value); }
+    static GF64x1 select(uint64_t mask, const GF64x1& a, const GF64x1& b) {
+        return GF64x1((uint8_t)((a.value & mask) | (b.value & ~mask)));
+    }
+    // 1 / x, 0 for x = 0
+    static GF64x1 inverse(const GF64x1& x) {
+        return GF64x1(pow_table[(63 - log_table[x.value]) % 63] & (uint8_t)x.nonzero());
+    }
+};
+
+template<> struct LaneTraits<GF64x64> {
+    using Counter = Counter64;
+    static GF64x64 broadcast(uint8_t value) {
+        GF64x64 result;
+        for(int b = 0; b < 6; b++) result.bit[b] = 0 - (uint64_t)((value >> b) & 1);
+        return result;
+    }
+    static GF64x64 select(uint64_t mask, const GF64x64& a, const GF64x64& b) {
+        GF64x64 result;
+        for(int p = 0; p < 6; p++) result.bit[p] = (a.bit[p] & mask) | (b.bit[p] & ~mask);
+        return result;
+    }
+    // 1 / x = x^62 = x^2 * x^4 * x^8 * x^16 * x^32 (0 stays 0)
+    static GF64x64 inverse(const GF64x64& x) {
+        GF64x64 square = x * x, result = square;
+        for(int i = 0; i < 4; i++) {
+            square = square * square;
+            result = result * square;
+        }
+        return result;
+    }
+};
+
+template<typename Lane>
+class ConstantTimeKernel {
+    private:
+        using Traits = LaneTraits<Lane>;
+        using Counter = typename Traits::Counter;
+        static const int n = RS63_42::n;
+        static const int parity = RS63_42::parity;
+        // Lambda(x) and B(x) coefficients: both have degree <= r before iteration r, so <= 21 at the end
+        static const int size = parity + 1;
+
+        // Move the Chien registers to the next position: register J is multiplied by a^(-(J + 1))
+        template<int... J>
+        static void chien_step(Lane* registers, std::integer_sequence<int, J...>) {
+            ((registers[J] = registers[J].template multiply_constant<pow_table[(63 - J - 1) % 63]>()), ...);
+        }
+        // Degree of a polynomial with count coefficients (0 for the zero polynomial)
+        static Counter degree(const Lane* p, int count) {
+            Counter result(0);
+            for(int j = 1; j < count; j++) result = Counter::select(p[j].nonzero(), Counter(j), result);
+            return result;
+        }
+
+    public:
+        struct Result {
+            uint64_t zero_syndrome;   // Nothing to correct
+            uint64_t corrected;       // Correctable, the corrections were applied
+        };
+
+        // received: 63 symbols (erased symbols 0), S: the 21 syndromes, X: the erasure locators
+        // a^i packed from slot 0 (unused slots 0, at most 21 erasures). Writes the corrected
+        // symbols (received ones where the frame is not correctable) to corrected.
+        static Result decode(const Lane* received, const Lane* S, const Lane* X, Lane* corrected) {
+            const Lane one = Traits::broadcast(1);
+            Lane lambda[size], B[size], gamma = one;
+            lambda[0] = B[0] = one;
+            Counter D(0), erasures(0);
+            for(int r = 0; r < parity; r++) {
+                // Coefficients above x^(r + 1) stay 0 in this iteration (the bound depends on r only)
+                const int top = r + 2;
+                uint64_t erasure = X[r].nonzero();
+                // Erasure step: Lambda(x) * (1 + X_r x)
+                Lane erased[size];
+                erased[0] = lambda[0];
+                for(int j = 1; j < top; j++) erased[j] = lambda[j] + X[r] * lambda[j - 1];
+                // Berlekamp-Massey step without inversion
+                Lane delta;
+                for(int j = 0; j <= r; j++) delta = delta + lambda[j] * S[r - j];
+                uint64_t change = ~erasure & delta.nonzero() & ~D.negative();
+                for(int j = top - 1; j >= 0; j--) {
+                    Lane shifted = j > 0 ? B[j - 1] : Lane();
+                    Lane updated = gamma * lambda[j] + delta * shifted;
+                    // B = Lambda after a length change (the new Lambda in the erasure steps), else x * B
+                    B[j] = Traits::select(erasure, erased[j], Traits::select(change, lambda[j], shifted));
+                    lambda[j] = Traits::select(erasure, erased[j], updated);
+                }
+                gamma = Traits::select(change, delta, gamma);
+                D = Counter::select(erasure, D, Counter::select(change, ~D, D.increment(~0ULL)));
+                erasures = erasures.increment(erasure);
+            }
+            // omega(x) = Lambda(x) * S(x) mod x^21
+            Lane omega[parity];
+            for(int i = 0; i < parity; i++) {
+                Lane value;
+                for(int j = 0; j <= i; j++) value = value + lambda[j] * S[i - j];
+                omega[i] = value;
+            }
+            // Chien search at every position, X = a^(-i): the error value is
+            // omega(X) / Lambda'(X) = X * omega(X) / (X * Lambda'(X)), masked by the root test.
+            // The registers hold Lambda_j X^j and omega_j X^(j + 1); the 63 denominators are
+            // inverted together (prefix products, one inversion, and back), 0 is replaced by 1.
+            Lane numerator[n], denominator[n], prefix[n];
+            uint64_t root[n];
+            Counter roots(0);
+            Lane registers[size], omega_registers[parity];
+            for(int j = 0; j < size; j++) registers[j] = lambda[j];
+            for(int j = 0; j < parity; j++) omega_registers[j] = omega[j];
+            for(int i = 0; i < n; i++) {
+                Lane even, odd, omega_X;
+                for(int j = 0; j < size; j += 2) even = even + registers[j];
+                for(int j = 1; j < size; j += 2) odd = odd + registers[j];
+                for(int j = 0; j < parity; j++) omega_X = omega_X + omega_registers[j];
+                root[i] = ~(even + odd).nonzero() & odd.nonzero();
+                numerator[i] = omega_X;
+                denominator[i] = Traits::select(odd.nonzero(), odd, one);
+                prefix[i] = i > 0 ? prefix[i - 1] * denominator[i] : denominator[i];
+                roots = roots.increment(root[i]);
+                chien_step(registers + 1, std::make_integer_sequence<int, size - 1>());
+                chien_step(omega_registers, std::make_integer_sequence<int, parity>());
+            }
+            Lane error[n], inverse = Traits::inverse(prefix[n - 1]);
+            for(int i = n - 1; i >= 0; i--) {
+                Lane value = numerator[i] * (i > 0 ? inverse * prefix[i - 1] : inverse);
+                inverse = inverse * denominator[i];
+                error[i] = Traits::select(root[i], value, Lane());
+            }
+            // The checks of berlekampMasseyAlgorithm and correctErrors: 2L = 21 + e - D
+            Counter locator_degree = degree(lambda, size);
+            Counter twice_L = Counter(parity) + erasures - D;
+            uint64_t valid = (locator_degree + locator_degree).equals(twice_L) & ~D.negative() &
+                      lambda[0].nonzero() & (degree(omega, parity) - locator_degree).negative() &
+                      roots.equals(locator_degree);
+            uint64_t dirty = 0;
+            for(int j = 0; j < parity; j++) dirty |= S[j].nonzero();
+            for(int i = 0; i < n; i++) corrected[i] = received[i] + Traits::select(valid & dirty, error[i], Lane());
+            return {~dirty, valid & dirty};
+        }
+};
+
+// Decoder front end: one frame with GF64x1 lanes, or groups of 64 frames with GF64x64 lanes
+// The frames are loaded and the syndromes computed as in ReedSolomonDecoder and BitslicedDecoder
+// (fixed work per frame); the status is decided from the result masks without branches.
+class ConstantTimeDecoder {
+    private:
+        static const int n = RS63_42::n;
+        static const int parity = RS63_42::parity;
+        const SyndromeTableEngine* syndrome_engine = &SyndromeTableEngine::instance();
+        BitslicedDecoder bitsliced;
+        // Erasure slots of a group (slots[s][f] = slot s of frame f) and the decoded symbols turned
+        // around bytewise (transposed[i][f] = symbol i of frame f)
+        alignas(32) uint8_t slots[parity][64];
+        alignas(32) uint8_t transposed[63][64];
+
+        // The erasure locators a^i of the lowest 21 bits of mask in slots 0 ~ 20 (0 when unused)
+        static void erasure_slots(uint64_t mask, uint8_t* slots) {
+            for(int s = 0; s < parity; s++) {
+                uint64_t used = 0 - (uint64_t)(mask != 0);
+                slots[s] = pow_table[__builtin_ctzll(mask | (1ULL << 62))] & (uint8_t)used;
+                mask &= mask - 1;
+            }
+        }
+        // Bit-slice rows of 64 bytes (lane f = byte f), the planes of 8 lanes are gathered from one
+        // word with a multiply as in BitslicedDecoder::load_frames
+        static void slice(const uint8_t (*bytes)[64], int rows, GF64x64* planes) {
+            for(int i = 0; i < rows; i++) {
+                for(int b = 0; b < 6; b++) planes[i].bit[b] = 0;
+                for(int group = 0; group < 8; group++) {
+                    uint64_t packed;
+                    memcpy(&packed, &bytes[i][group * 8], 8);
+                    for(int b = 0; b < 6; b++) {
+                        uint64_t bits = (((packed >> b) & 0x0101010101010101ULL) * 0x0102040810204080ULL) >> 56;
+                        planes[i].bit[b] |= bits << (8 * group);
+                    }
+                }
+            }
+        }
+        // And back: byte k of a group word gets bit k of the 8 plane bits
+        static void unslice(const GF64x64* planes, int rows, uint8_t (*bytes)[64]) {
+            for(int i = 0; i < rows; i++) {
+                for(int group = 0; group < 8; group++) {
+                    uint64_t packed = 0;
+                    for(int b = 0; b < 6; b++) {
+                        uint64_t bits = (((planes[i].bit[b] >> (8 * group)) & 0xFF) * 0x0101010101010101ULL) &
+                                        0x8040201008040201ULL;
+                        bits = (((bits + 0x7F7F7F7F7F7F7F7FULL) | bits) & 0x8080808080808080ULL) >> 7;
+                        packed |= bits << b;
+                    }
+                    memcpy(&bytes[i][group * 8], &packed, 8);
+                }
+            }
+        }
+        static uint8_t status_of(uint64_t malformed, uint64_t zero_syndrome, uint64_t too_many, uint64_t corrected) {
+            int status = DECODE_UNCORRECTABLE;
+            status = corrected ? DECODE_CORRECTED : status;
+            status = too_many ? DECODE_TOO_MANY_ERASURES : status;
+            status = zero_syndrome ? DECODE_OK : status;
+            status = malformed ? DECODE_MALFORMED : status;
+            return (uint8_t)status;
+        }
+        // All ones when a symbol that is not erased is above 63, without branches
+        static uint64_t invalid_symbols(const uint8_t* received, uint64_t erasure_mask) {
+            uint8_t invalid = 0;
+            for(int i = 0; i < n; i++) invalid |= received[i] & ~(uint8_t)(0 - ((erasure_mask >> i) & 1));
+            return 0 - (uint64_t)((invalid & ~63) != 0);
+        }
+
+    public:
+        // Same interface and results as ReedSolomonDecoder::decode_frame
+        DecodeStatus decode_frame(const uint8_t* received, uint64_t erasure_mask, uint8_t* codeword) {
+            erasure_mask &= (1ULL << n) - 1;
+            alignas(32) uint8_t symbols[64], values[32], slots[parity];
+            for(int i = 0; i < n; i++) symbols[i] = received[i] & 63 & ~(uint8_t)(0 - ((erasure_mask >> i) & 1));
+            symbols[63] = 0;
+            syndrome_engine->compute(symbols, values);
+            erasure_slots(erasure_mask, slots);
+            GF64x1 R[n], S[parity], X[parity], corrected[n];
+            for(int i = 0; i < n; i++) R[i] = GF64x1(symbols[i]);
+            for(int j = 0; j < parity; j++) {
+                S[j] = GF64x1(values[j]);
+                X[j] = GF64x1(slots[j]);
+            }
+            uint64_t too_many = 0 - (uint64_t)(__builtin_popcountll(erasure_mask) > parity);
+            uint64_t malformed = invalid_symbols(received, erasure_mask);
+            // More than 21 erasures do not fit the slots, the frame is passed through
+            ConstantTimeKernel<GF64x1>::Result result = ConstantTimeKernel<GF64x1>::decode(R, S, X, corrected);
+            uint64_t applied = result.corrected & ~too_many & ~malformed;
+            for(int i = 0; i < n; i++) codeword[i] = LaneTraits<GF64x1>::select(applied, corrected[i], R[i]).value;
+            return (DecodeStatus)status_of(malformed, result.zero_syndrome, too_many, applied);
+        }
+
+        // Decode count frames in groups of 64 bit-sliced lanes, same layout and results as
+        // ReedSolomonDecoder::decode_batch
+        void decode_batch(const uint8_t* symbols, const uint64_t* erasure_masks, size_t count,
+                          uint8_t* corrected, uint8_t* status, size_t stride = CodewordBatch::stride) {
+            for(size_t first = 0; first < count; first += 64) {
+                size_t group = std::min<size_t>(64, count - first);
+                decode_group(symbols + first * stride, erasure_masks + first, group,
+                             corrected + first * stride, status + first, stride);
+            }
+        }
+        void decode_batch(CodewordBatch& batch) {
+            decode_batch(batch.symbols, batch.erasure_masks, batch.count, batch.corrected, batch.status);
+        }
+
+    private:
+        void decode_group(const uint8_t* symbols, const uint64_t* erasure_masks, size_t count,
+                          uint8_t* corrected, uint8_t* status, size_t stride) {
+            GF64x64 R[n], S[parity], X[parity], result[n];
+            // corrected receives the frames with their erased symbols set to 0
+            bitsliced.load_frames(symbols, erasure_masks, count, stride, corrected, R);
+            BitslicedDecoder::syndromes(R, S, std::make_integer_sequence<int, parity>());
+            uint64_t too_many = 0, malformed = 0;
+            for(size_t f = 0; f < 64; f++) {
+                uint64_t mask = f < count ? erasure_masks[f] & ((1ULL << n) - 1) : 0;
+                uint8_t frame_slots[parity];
+                erasure_slots(mask, frame_slots);
+                for(int s = 0; s < parity; s++) slots[s][f] = frame_slots[s];
+                too_many |= (uint64_t)(__builtin_popcountll(mask) > parity) << f;
+                if(f < count) malformed |= invalid_symbols(symbols + f * stride, mask) & (1ULL << f);
+            }
+            slice(slots, parity, X);
+            ConstantTimeKernel<GF64x64>::Result masks = ConstantTimeKernel<GF64x64>::decode(R, S, X, result);
+            uint64_t applied = masks.corrected & ~too_many & ~malformed;
+            for(int i = 0; i < n; i++) result[i] = LaneTraits<GF64x64>::select(applied, result[i], R[i]);
+            unslice(result, n, transposed);
+            for(size_t f = 0; f < count; f++) {
+                uint8_t* out = corrected + f * stride;
+                for(int i = 0; i < n; i++) out[i] = transposed[i][f];
+                status[f] = status_of((malformed >> f) & 1, (masks.zero_syndrome >> f) & 1, (too_many >> f) & 1,
+                                      (applied >> f) & 1);
+            }
+        }
+};
+
+#endif
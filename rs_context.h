@@ -0,0 +1,149 @@
+#ifndef RS_CONTEXT_H
+#define RS_CONTEXT_H
+
+#include <cstdint>
+#include <cstring>
+#include "rs_decoder.h"
+
+// Stateful decode context for frames that are decoded again after small changes
+// (a retransmission that fills in some symbols, erasure flags that are set or cleared, ...)
+// The context keeps the syndromes of the received word and its erasure locator up to date:
+//  - update_symbol adds the contribution of old ^ new at one position (one 21-symbol row)
+//  - set_erasure removes or adds the contribution of the symbol, and multiplies or divides
+//    the erasure locator by (1 + a^i x)
+// so a change costs O(21) instead of recomputing the syndromes of all 63 symbols, and decode()
+// only runs the stages after the erasure locator. The result is cached until the frame changes.
+// One context per frame and thread; several contexts can share the decoder.
+class DecodeContext {
+    private:
+        static const int n = RS63_42::n;
+        static const int parity = RS63_42::parity;
+        ReedSolomonDecoder& decoder;
+        const SyndromeTableEngine& engine;
+        DecoderWorkspace ws;
+        uint8_t symbols[64];                 // Received values, also kept at the erased positions
+        uint64_t erasure_mask;
+        uint64_t invalid_mask;               // Received values above 63 (the frame is malformed unless erased)
+        bool bad_position;                   // An update named a position outside 0~62 since the last load
+        alignas(32) uint8_t syndromes[32];   // Syndromes with the erased symbols set to 0
+        GF64 erasure_locator[64];            // Gamma(x), degree = number of erasures
+        int num_erasures;
+        // Result of the last decode, valid while decoded is true
+        bool decoded;
+        DecodeStatus status;
+        uint8_t result[64];
+
+    public:
+        explicit DecodeContext(ReedSolomonDecoder& decoder)
+            : decoder(decoder), engine(SyndromeTableEngine::instance()) {
+            uint8_t zero[64] = {0};
+            load(zero, 0);
+        }
+
+        // Start over with a new frame (63 symbols, bit i of erasure_mask marks symbol i as erased)
+        void load(const uint8_t* received, uint64_t erasure_mask) {
+            this->erasure_mask = erasure_mask & ((1ULL << n) - 1);
+            invalid_mask = 0;
+            bad_position = false;
+            for(int i = 0; i < n; i++) {
+                invalid_mask |= (uint64_t)(received[i] > 63) << i;
+                symbols[i] = received[i] & 63;
+                result[i] = ((this->erasure_mask >> i) & 1) ? 0 : symbols[i];
+            }
+            symbols[n] = result[n] = 0;
+            engine.compute(result, syndromes);
+            erasure_locator[0] = GF64(1);
+            num_erasures = 0;
+            for(uint64_t mask = this->erasure_mask; mask != 0; mask &= mask - 1) {
+                multiply_locator(__builtin_ctzll(mask));
+            }
+            decoded = false;
+        }
+
+        // Replace the received value of one symbol (an erased symbol stays erased)
+        // A position outside 0~62 changes nothing, returns false and makes the frame
+        // DECODE_MALFORMED until the next load.
+        bool update_symbol(int position, uint8_t value) {
+            if(!check_position(position)) return false;
+            uint64_t invalid = (invalid_mask & ~(1ULL << position)) | ((uint64_t)(value > 63) << position);
+            value &= 63;
+            if(value == symbols[position] && invalid == invalid_mask) return true;
+            invalid_mask = invalid;
+            if(!((erasure_mask >> position) & 1)) engine.add(position, symbols[position] ^ value, syndromes);
+            symbols[position] = value;
+            decoded = false;
+            return true;
+        }
+
+        // Mark one symbol as erased or not, an unerased symbol gets back its received value
+        // A position outside 0~62 is handled as in update_symbol.
+        bool set_erasure(int position, bool erased) {
+            if(!check_position(position)) return false;
+            if(((erasure_mask >> position) & 1) == (uint64_t)erased) return true;
+            // Erasing sets the symbol to 0 for the syndromes, unerasing adds its value back
+            engine.add(position, symbols[position], syndromes);
+            if(erased) multiply_locator(position);
+            else divide_locator(position);
+            erasure_mask ^= 1ULL << position;
+            decoded = false;
+            return true;
+        }
+
+        const uint8_t* received() const { return symbols; }
+        uint64_t erasures() const { return erasure_mask; }
+
+        // Decode the current frame into codeword (63 symbols), like ReedSolomonDecoder::decode_frame
+        DecodeStatus decode(uint8_t* codeword) {
+            if(!decoded) {
+                RS_STATS_START(stats_start, stats_clock);
+                for(int i = 0; i < n; i++) result[i] = ((erasure_mask >> i) & 1) ? 0 : symbols[i];
+                uint64_t words[4];
+                memcpy(words, syndromes, 32);
+                if(bad_position || (invalid_mask & ~erasure_mask)) status = DECODE_MALFORMED;
+                else if((words[0] | words[1] | words[2]) == 0) status = DECODE_OK;
+                else if(num_erasures > parity) status = DECODE_TOO_MANY_ERASURES;
+                else {
+                    // Hand the cached syndromes and erasure locator to the remaining stages
+                    decoder.loadSyndromes(syndromes, ws.syndromes);
+                    ws.erasure_locator.clear();
+                    for(int j = num_erasures; j >= 0; j--) ws.erasure_locator.set_coefficients(j, erasure_locator[j]);
+                    decoder.calculateForneySyndromes(ws);
+                    RS_STATS_STAGE(stats_clock, STAGE_ERASURE_LOCATOR);
+                    status = decoder.correctFrame(erasure_mask, result, ws);
+                }
+                status = RS_STATS_RESULT(status, stats_start);
+                decoded = true;
+            }
+            memcpy(codeword, result, n);
+            return status;
+        }
+
+    private:
+        // Positions outside 0~62 mark the frame malformed (and drop the cached result)
+        bool check_position(int position) {
+            if(position >= 0 && position < n) return true;
+            if(!bad_position) decoded = false;
+            bad_position = true;
+            return false;
+        }
+        // Gamma(x) = Gamma(x) * (1 + a^i x)
+        void multiply_locator(int position) {
+            GF64 alpha(pow_table[position]);
+            erasure_locator[num_erasures + 1] = GF64(0);
+            for(int j = num_erasures + 1; j > 0; j--) {
+                erasure_locator[j] = erasure_locator[j] + erasure_locator[j - 1] * alpha;
+            }
+            num_erasures++;
+        }
+        // Gamma(x) = Gamma(x) / (1 + a^i x), the division is exact (synthetic division from x^0)
+        void divide_locator(int position) {
+            GF64 alpha(pow_table[position]);
+            for(int j = 1; j < num_erasures; j++) {
+                erasure_locator[j] = erasure_locator[j] + erasure_locator[j - 1] * alpha;
+            }
+            erasure_locator[num_erasures] = GF64(0);
+            num_erasures--;
+        }
+};
+
+#endif
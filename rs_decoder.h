@@ -0,0 +1,727 @@
+#ifndef RS_DECODER_H
+#define RS_DECODER_H
+
+#include <iostream>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#if defined(__AVX2__) || defined(__SSSE3__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+#include "gf64.h"
+#include "gf64_fft.h"
+#include "gf64_poly.h"
+#include "rs_codec.h"
+#include "rs_stats.h"
+
+// DecodeStatus (the per-frame result of decode_frame and decode_batch) is defined in rs_codec.h
+
+// Struct-of-arrays buffer holding N frames for decode_batch
+// Every frame occupies one 64-byte line (63 symbols + 1 byte of padding),
+// and the erasures of a frame are packed in a 63-bit mask (bit i = symbol i)
+struct CodewordBatch {
+    static const int stride = 64;
+    size_t count;
+    uint8_t* symbols;         // count * stride received symbols
+    uint64_t* erasure_masks;  // count erasure masks
+    uint8_t* corrected;       // count * stride decoded symbols
+    uint8_t* status;          // count DecodeStatus values
+
+    CodewordBatch(size_t count) {
+        this->count = count;
+        symbols = allocate<uint8_t>(count * stride);
+        erasure_masks = allocate<uint64_t>(count);
+        corrected = allocate<uint8_t>(count * stride);
+        status = allocate<uint8_t>(count);
+    }
+    ~CodewordBatch() {
+        std::free(symbols);
+        std::free(erasure_masks);
+        std::free(corrected);
+        std::free(status);
+    }
+    CodewordBatch(const CodewordBatch&) = delete;
+    CodewordBatch& operator=(const CodewordBatch&) = delete;
+    // Get the received symbols of a frame
+    uint8_t* frame(size_t index) { return symbols + index * stride; }
+    // Get the decoded symbols of a frame
+    uint8_t* corrected_frame(size_t index) { return corrected + index * stride; }
+
+private:
+    // Cache-line aligned, zero filled allocation (aligned_alloc needs a multiple of the alignment)
+    template<typename T>
+    static T* allocate(size_t n) {
+        size_t bytes = (n * sizeof(T) + 63) / 64 * 64;
+        if(bytes == 0) bytes = 64;
+        T* ptr = static_cast<T*>(std::aligned_alloc(64, bytes));
+        if(ptr == nullptr) throw std::bad_alloc();
+        std::fill(reinterpret_cast<uint8_t*>(ptr), reinterpret_cast<uint8_t*>(ptr) + bytes, 0);
+        return ptr;
+    }
+};
+
+// Syndrome engine using split-nibble multiply tables (PSHUFB / VPSHUFB)
+// S_j = sum(r_i * a^(i*j)), j = 1~21: for every position the 21 powers a^(i*j) are stored
+// as one 32-byte row split into low nibbles and high 2 bits, and r_i * row is computed with
+// two 16-entry lookups (r_i * lo) ^ (r_i * (hi << 4)) in every lane at once.
+// The scalar fallback performs the same lookups lane by lane, so the results are bit-identical.
+// It needs only 6 KB of tables; the decoder uses SyndromeTableEngine, which is about twice as fast.
+class SyndromeEngine {
+    private:
+        alignas(32) uint8_t mul_lo[64][16];     // mul_lo[r][x] = r * x, x = 0~15
+        alignas(32) uint8_t mul_hi[64][16];     // mul_hi[r][x] = r * (x << 4), x = 0~3 (rest 0)
+        alignas(32) uint8_t alpha_lo[63][32];   // low nibble of a^(i*(j+1)), j = 0~20 (rest 0)
+        alignas(32) uint8_t alpha_hi[63][32];   // high 2 bits of a^(i*(j+1)), j = 0~20 (rest 0)
+    public:
+        SyndromeEngine() {
+            for(int r = 0; r < 64; r++) {
+                for(int x = 0; x < 16; x++) {
+                    mul_lo[r][x] = (GF64(r) * GF64(x)).get_value();
+                    mul_hi[r][x] = x < 4 ? (GF64(r) * GF64(x << 4)).get_value() : 0;
+                }
+            }
+            for(int i = 0; i < 63; i++) {
+                for(int j = 0; j < 32; j++) {
+                    int alpha = j < 21 ? pow_table[(i * (j + 1)) % 63] : 0;
+                    alpha_lo[i][j] = alpha & 15;
+                    alpha_hi[i][j] = alpha >> 4;
+                }
+            }
+        }
+        // Compute the 21 syndromes of 63 received symbols (values 0~63, erasures set to 0)
+        // syndromes must hold 32 bytes, entries 21~31 are written as 0
+        void compute(const uint8_t* received, uint8_t* syndromes) const {
+#if defined(__AVX2__)
+            compute_avx2(received, syndromes);
+#elif defined(__SSSE3__)
+            compute_ssse3(received, syndromes);
+#else
+            compute_scalar(received, syndromes);
+#endif
+        }
+        void compute_scalar(const uint8_t* received, uint8_t* syndromes) const {
+            for(int j = 0; j < 32; j++) syndromes[j] = 0;
+            for(int i = 0; i < 63; i++) {
+                const uint8_t* lo = mul_lo[received[i]];
+                const uint8_t* hi = mul_hi[received[i]];
+                for(int j = 0; j < 21; j++) {
+                    syndromes[j] ^= lo[alpha_lo[i][j]] ^ hi[alpha_hi[i][j]];
+                }
+            }
+        }
+#if defined(__SSSE3__)
+        void compute_ssse3(const uint8_t* received, uint8_t* syndromes) const {
+            __m128i acc0 = _mm_setzero_si128(), acc1 = _mm_setzero_si128();
+            for(int i = 0; i < 63; i++) {
+                __m128i lo = _mm_load_si128((const __m128i*)mul_lo[received[i]]);
+                __m128i hi = _mm_load_si128((const __m128i*)mul_hi[received[i]]);
+                acc0 = _mm_xor_si128(acc0, _mm_xor_si128(
+                    _mm_shuffle_epi8(lo, _mm_load_si128((const __m128i*)alpha_lo[i])),
+                    _mm_shuffle_epi8(hi, _mm_load_si128((const __m128i*)alpha_hi[i]))));
+                acc1 = _mm_xor_si128(acc1, _mm_xor_si128(
+                    _mm_shuffle_epi8(lo, _mm_load_si128((const __m128i*)(alpha_lo[i] + 16))),
+                    _mm_shuffle_epi8(hi, _mm_load_si128((const __m128i*)(alpha_hi[i] + 16)))));
+            }
+            _mm_storeu_si128((__m128i*)syndromes, acc0);
+            _mm_storeu_si128((__m128i*)(syndromes + 16), acc1);
+        }
+#endif
+#if defined(__AVX2__)
+        void compute_avx2(const uint8_t* received, uint8_t* syndromes) const {
+            __m256i acc = _mm256_setzero_si256();
+            for(int i = 0; i < 63; i++) {
+                // VPSHUFB looks up within each 128-bit lane, so the 16-entry tables are broadcast
+                __m256i lo = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)mul_lo[received[i]]));
+                __m256i hi = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)mul_hi[received[i]]));
+                acc = _mm256_xor_si256(acc, _mm256_xor_si256(
+                    _mm256_shuffle_epi8(lo, _mm256_load_si256((const __m256i*)alpha_lo[i])),
+                    _mm256_shuffle_epi8(hi, _mm256_load_si256((const __m256i*)alpha_hi[i]))));
+            }
+            _mm256_storeu_si256((__m256i*)syndromes, acc);
+        }
+#endif
+};
+
+// Syndrome engine using position x value contribution tables
+// rows[i][r] holds the 21 syndrome contributions r * a^(i*j), j = 1~21, of value r at position i,
+// padded to 32 bytes, so the syndromes are the XOR of 63 rows picked by the received symbols
+// (one 32-byte load and XOR per symbol). The table takes 63 * 64 * 32 bytes = 126 KB (84 KB of
+// contributions); it is built once and shared read-only by every decoder and thread, so the
+// decode workers keep one copy in their caches.
+class SyndromeTableEngine {
+    private:
+        alignas(32) uint8_t rows[63][64][32];
+
+        SyndromeTableEngine() {
+            for(int i = 0; i < 63; i++) {
+                for(int r = 0; r < 64; r++) {
+                    for(int j = 0; j < 32; j++) {
+                        rows[i][r][j] = j < 21 ? (GF64(r) * GF64(pow_table[(i * (j + 1)) % 63])).get_value() : 0;
+                    }
+                }
+            }
+        }
+    public:
+        SyndromeTableEngine(const SyndromeTableEngine&) = delete;
+        SyndromeTableEngine& operator=(const SyndromeTableEngine&) = delete;
+        // The shared table, built on first use
+        static const SyndromeTableEngine& instance() {
+            static const SyndromeTableEngine* engine = new SyndromeTableEngine();
+            return *engine;
+        }
+        // Compute the 21 syndromes of 63 received symbols (values 0~63, erasures set to 0)
+        // syndromes must hold 32 bytes, entries 21~31 are written as 0
+        void compute(const uint8_t* received, uint8_t* syndromes) const {
+#if defined(__AVX2__)
+            compute_avx2(received, syndromes);
+#elif defined(__SSE2__)
+            compute_sse2(received, syndromes);
+#else
+            compute_scalar(received, syndromes);
+#endif
+        }
+        // Add the contribution of value at position to 32 bytes of syndromes
+        // The rows are linear in the value, so adding old ^ new replaces old by new
+        void add(int position, uint8_t value, uint8_t* syndromes) const {
+            uint64_t row[4], acc[4];
+            memcpy(row, rows[position][value & 63], 32);
+            memcpy(acc, syndromes, 32);
+            for(int w = 0; w < 4; w++) acc[w] ^= row[w];
+            memcpy(syndromes, acc, 32);
+        }
+        // Syndromes of a shortened RS(63-s, 42-s) frame: message_length = 42 - s message symbols
+        // followed by 21 parity symbols. The implied zeros (positions message_length~41) add
+        // nothing, so their rows are skipped and the cost shrinks with the frame.
+        void compute_shortened(const uint8_t* received, int message_length, uint8_t* syndromes) const {
+#if defined(__AVX2__)
+            __m256i acc0 = _mm256_setzero_si256(), acc1 = _mm256_setzero_si256();
+            for(int i = 0; i < message_length; i++) {
+                acc0 = _mm256_xor_si256(acc0, _mm256_load_si256((const __m256i*)rows[i][received[i]]));
+            }
+            for(int j = 0; j < 21; j++) {
+                acc1 = _mm256_xor_si256(acc1, _mm256_load_si256((const __m256i*)rows[42 + j][received[message_length + j]]));
+            }
+            _mm256_storeu_si256((__m256i*)syndromes, _mm256_xor_si256(acc0, acc1));
+#else
+            uint64_t acc[4] = {0, 0, 0, 0};
+            for(int i = 0; i < 63 - 42 + message_length; i++) {
+                uint64_t row[4];
+                memcpy(row, rows[i < message_length ? i : i - message_length + 42][received[i]], 32);
+                for(int w = 0; w < 4; w++) acc[w] ^= row[w];
+            }
+            memcpy(syndromes, acc, 32);
+#endif
+        }
+        void compute_scalar(const uint8_t* received, uint8_t* syndromes) const {
+            // Three 64-bit words cover the 21 contributions
+            uint64_t acc[3] = {0, 0, 0};
+            for(int i = 0; i < 63; i++) {
+                uint64_t row[3];
+                memcpy(row, rows[i][received[i]], 24);
+                acc[0] ^= row[0];
+                acc[1] ^= row[1];
+                acc[2] ^= row[2];
+            }
+            memcpy(syndromes, acc, 24);
+            memset(syndromes + 24, 0, 8);
+        }
+#if defined(__SSE2__)
+        void compute_sse2(const uint8_t* received, uint8_t* syndromes) const {
+            __m128i acc0 = _mm_setzero_si128(), acc1 = _mm_setzero_si128();
+            for(int i = 0; i < 63; i++) {
+                const uint8_t* row = rows[i][received[i]];
+                acc0 = _mm_xor_si128(acc0, _mm_load_si128((const __m128i*)row));
+                acc1 = _mm_xor_si128(acc1, _mm_load_si128((const __m128i*)(row + 16)));
+            }
+            _mm_storeu_si128((__m128i*)syndromes, acc0);
+            _mm_storeu_si128((__m128i*)(syndromes + 16), acc1);
+        }
+#endif
+#if defined(__AVX2__)
+        void compute_avx2(const uint8_t* received, uint8_t* syndromes) const {
+            // Two accumulators halve the dependency chain of the XORs
+            __m256i acc0 = _mm256_setzero_si256(), acc1 = _mm256_setzero_si256();
+            for(int i = 0; i < 62; i += 2) {
+                acc0 = _mm256_xor_si256(acc0, _mm256_load_si256((const __m256i*)rows[i][received[i]]));
+                acc1 = _mm256_xor_si256(acc1, _mm256_load_si256((const __m256i*)rows[i + 1][received[i + 1]]));
+            }
+            acc0 = _mm256_xor_si256(acc0, _mm256_load_si256((const __m256i*)rows[62][received[62]]));
+            _mm256_storeu_si256((__m256i*)syndromes, _mm256_xor_si256(acc0, acc1));
+        }
+#endif
+};
+
+// Algorithms that solve the key equation Lambda(x) * S(x) = omega(x) mod x^21
+enum KeyEquationSolver {
+    KEY_EQUATION_EUCLIDEAN,         // Sugiyama's Euclidean algorithm on x^21 and Gamma(x) * S(x)
+    KEY_EQUATION_BERLEKAMP_MASSEY   // Errors-and-erasures Berlekamp-Massey started from Gamma(x)
+};
+
+// Solver used by default, e.g. -DRS_KEY_EQUATION_SOLVER=KEY_EQUATION_BERLEKAMP_MASSEY
+#ifndef RS_KEY_EQUATION_SOLVER
+#define RS_KEY_EQUATION_SOLVER KEY_EQUATION_EUCLIDEAN
+#endif
+
+// Scratch polynomials of one decode, allocated once and reused for every frame
+// Each thread needs its own workspace
+struct DecoderWorkspace {
+    GF64_fixed_poly syndromes;          // S(x) = S_1 + S_2 x + ... + S_21 x^20
+    GF64_fixed_poly erasure_locator;    // Gamma(x)
+    GF64_fixed_poly forney_syndromes;   // T(x) = Gamma(x) * S(x) mod x^21
+    GF64_fixed_poly error_locator;      // sigma(x)
+    GF64_fixed_poly evaluator;          // omega(x)
+    GF64_fixed_poly locator;            // Lambda(x) = sigma(x) * Gamma(x)
+    // Euclidean algorithm remainders R_(i-1), R_i, locators V_(i-1), V_i and temporaries
+    GF64_fixed_poly R_prev, R_cur, V_prev, V_cur, Q, R_next;
+    // Error positions and values found by correctErrors
+    int error_positions[63];
+    GF64 error_values[63];
+    int num_errors;
+};
+
+class ReedSolomonDecoder {
+    private:
+        static const int n = RS63_42::n;  // Code length
+        static const int k = RS63_42::k;  // Message length
+        static const int t = RS63_42::t;  // Error correction capability
+        static const int parity = RS63_42::parity;  // Number of syndromes
+        // Shared contribution tables (SyndromeTableEngine::instance())
+        const SyndromeTableEngine* syndrome_engine = &SyndromeTableEngine::instance();
+        KeyEquationSolver key_equation_solver;
+        // Locator degree from which correctErrors uses transformSearch instead of chienSearch
+        // (`benchmark transform`: about 0.9x at degree 4, 0.84-1.29x at 6, 1.3x or more from 8)
+        static const int transform_min_degree = 8;
+        // The bit-sliced, incremental and GMD decoders reuse the per-frame stages, the benchmark
+        // times them one by one
+        friend class BitslicedDecoder;
+        friend class DecoderStageBenchmark;
+        friend class DecodeContext;
+        friend class GMDDecoder;
+    
+    // Calculate syndromes of received symbols packed one per byte (erasures set to 0)
+    void calculateSyndromes(const uint8_t* received, GF64_fixed_poly& syndromes) {
+        // Syndrome S_j = sum(a^ij * c_i), j = 1~21
+        alignas(32) uint8_t values[32];
+        syndrome_engine->compute(received, values);
+        loadSyndromes(values, syndromes);
+    }
+    // Save the syndrome bytes with shifted ( syndromes[j] = s_(j+1) )
+    void loadSyndromes(const uint8_t* values, GF64_fixed_poly& syndromes) {
+        syndromes.clear();
+        for (int j = 20; j >= 0; j--) {
+            if (values[j] != 0) syndromes.set_coefficients(j, GF64(values[j]));
+        }
+    }
+
+    // Calculate erasure locator polynomial (the caller makes sure there are at most 21 erasures)
+    void calculateErasureLocator(uint64_t erasure_mask, GF64_fixed_poly& erasureLocator) {
+        // Initialize the erasure locator polynomial
+        erasureLocator = GF64_fixed_poly(GF64(1));
+        for (int i = 0; i < n; i++) {
+            if ((erasure_mask >> i) & 1) {
+                // Multiply by (1 + a^i * x) in place
+                int degree = erasureLocator.get_degree();
+                GF64 alpha(pow_table[i]);
+                for (int j = degree + 1; j > 0; j--) {
+                    erasureLocator.set_coefficients(j, erasureLocator.get_coefficient(j) +
+                                                       erasureLocator.get_coefficient(j - 1) * alpha);
+                }
+            }
+        }
+    }
+
+    // Forney (modified) syndromes T(x) = Gamma(x) * S(x) mod x^21, used by the erasure-only
+    // check and as the first remainder of the Euclidean algorithm
+    void calculateForneySyndromes(DecoderWorkspace& ws) {
+        ws.forney_syndromes = (ws.erasure_locator * ws.syndromes).mod_x21();
+    }
+
+    // Euclidean algorithm, leaves the error locator and error evaluator in the workspace
+    void euclideanAlgorithm(DecoderWorkspace& ws) {
+        int num_of_erasures = ws.erasure_locator.get_degree();
+        // mu = lower bound of (r-e_0)/2
+        int mu = (21 - num_of_erasures) / 2;
+        // nu = upper bound of (r+e_0)/2 - 1
+        int nu = (21 + num_of_erasures + 1) / 2 - 1; 
+        // R_0 = x^r = x^21, R_1 = S_0
+        ws.R_prev.clear();
+        ws.R_prev.set_coefficients(21, GF64(1));
+        // Modified Syndrome Polynomial S_0 = Gamma(x) * S(x) mod x^21
+        ws.R_cur = ws.forney_syndromes;
+        // V_0 = 0, V_1 = 1 (U_i is never used, so it is not tracked)
+        ws.V_prev = GF64_fixed_poly(GF64(0));
+        ws.V_cur = GF64_fixed_poly(GF64(1));
+        while(ws.R_cur.get_degree() > nu || ws.V_cur.get_degree() > mu){
+            // Q_i = R_(i-2) / R_(i-1), R_i = R_(i-2) + R_(i-1) * Q_i is the remainder
+            // A zero remainder cannot be divided any further, correctErrors rejects the result
+            if(!ws.R_prev.divide(ws.R_cur, ws.Q, ws.R_next)) break;
+            ws.R_prev = ws.R_cur;
+            ws.R_cur = ws.R_next;
+            // V_i = V_(i-2) + V_(i-1) * Q_i
+            GF64_fixed_poly V_next = ws.V_prev + ws.V_cur * ws.Q;
+            ws.V_prev = ws.V_cur;
+            ws.V_cur = V_next;
+        }
+        // Return the error locator and error evaluator
+        ws.error_locator = ws.V_cur;
+        ws.evaluator = ws.R_cur;
+        ws.locator = ws.error_locator * ws.erasure_locator;
+    }
+
+    // Errors-and-erasures Berlekamp-Massey algorithm, leaves the error and erasure locator
+    // Lambda(x) and the error evaluator omega(x) = Lambda(x) * S(x) mod x^21 in the workspace
+    // The correction polynomial is kept as B(x) = x^B_shift * b(x), so multiplying it by x is free
+    // and every step only touches the deg(b) + 1 coefficients of b(x)
+    void berlekampMasseyAlgorithm(DecoderWorkspace& ws) {
+        const int size = parity + 2;
+        int num_of_erasures = ws.erasure_locator.get_degree();
+        GF64 S[parity], lambda[size], b[size], old_lambda[size];
+        for(int j = 0; j < parity; j++) S[j] = ws.syndromes.get_coefficient(j);
+        // Lambda(x) = B(x) = Gamma(x), the erasures are already located
+        for(int j = 0; j < size; j++) lambda[j] = b[j] = ws.erasure_locator.get_coefficient(j);
+        // deg(Lambda) <= L, deg(b) <= b_degree
+        int L = num_of_erasures, b_degree = num_of_erasures, B_shift = 0;
+        bool overflow = false;
+        for(int r = num_of_erasures + 1; r <= parity; r++) {
+            // Discrepancy delta = sum(Lambda_j * S_(r-j)) ( S_(r-j) = S[r-j-1] )
+            GF64 delta(0);
+            for(int j = 0; j <= L && j < r; j++) delta = delta + lambda[j] * S[r - j - 1];
+            if(delta.get_value() == 0) {
+                // B(x) = x * B(x)
+                B_shift++;
+                continue;
+            }
+            bool length_change = 2 * L <= r + num_of_erasures - 1;
+            if(length_change) {
+                for(int j = 0; j <= L; j++) old_lambda[j] = lambda[j];
+            }
+            // Lambda(x) = Lambda(x) + delta * x * B(x)
+            for(int j = 0; j <= b_degree; j++) {
+                int index = j + B_shift + 1;
+                if(index < size) lambda[index] = lambda[index] + delta * b[j];
+                else if(b[j].get_value() != 0) overflow = true;
+            }
+            if(length_change) {
+                // B(x) = old Lambda(x) / delta
+                GF64 delta_inverse = delta.inverse();
+                for(int j = 0; j <= L; j++) b[j] = old_lambda[j] * delta_inverse;
+                b_degree = L;
+                B_shift = 0;
+                L = r + num_of_erasures - L;
+            }
+            else {
+                // B(x) = x * B(x)
+                B_shift++;
+            }
+        }
+        ws.locator.clear();
+        for(int j = size - 1; j >= 0; j--) {
+            if(lambda[j].get_value() != 0) ws.locator.set_coefficients(j, lambda[j]);
+        }
+        // omega(x) = Lambda(x) * S(x) mod x^21
+        ws.evaluator.clear();
+        for(int i = parity - 1; i >= 0; i--) {
+            GF64 omega(0);
+            for(int j = 0; j <= i && j <= L; j++) omega = omega + lambda[j] * S[i - j];
+            if(omega.get_value() != 0) ws.evaluator.set_coefficients(i, omega);
+        }
+        // The locator is only valid if its degree is the register length and the errors fit in
+        // the redundancy ( 2 * (L - e_0) + e_0 <= 21 ), clearing it makes correctErrors reject the frame
+        if(overflow || ws.locator.get_degree() != L || 2 * L - num_of_erasures > parity) ws.locator.clear();
+    }
+
+    // Erasure-only decoding, used before the key equation when the erasure mask is not empty
+    // The Forney syndromes T_e ~ T_20 (e erasures) are the syndromes of the errors alone: if they
+    // are all zero the received word is a codeword once the erased values are filled in, so this
+    // is the syndrome check of the result, done before the correction. The locator is known, so
+    // no search is needed either: the value of erasure i is omega(X) / Gamma'(X) at X = a^(-i),
+    // with omega(x) = T_0 + ... + T_(e-1) x^(e-1).
+    // Returns false (and leaves nothing in the workspace) if there are errors besides the erasures.
+    bool correctErasures(uint64_t erasure_mask, DecoderWorkspace& ws) {
+        int num_of_erasures = ws.erasure_locator.get_degree();
+        if(ws.forney_syndromes.get_degree() >= num_of_erasures) return false;
+        GF64 gamma[parity + 1], omega[parity];
+        for(int j = 0; j <= num_of_erasures; j++) gamma[j] = ws.erasure_locator.get_coefficient(j);
+        for(int j = 0; j < num_of_erasures; j++) omega[j] = ws.forney_syndromes.get_coefficient(j);
+        // Evaluate at all erased positions together, so the products of different positions
+        // do not wait for each other
+        GF64 X[parity], omega_X[parity], odd[parity], power[parity];
+        for(int e = 0; e < num_of_erasures; e++) {
+            int i = __builtin_ctzll(erasure_mask);
+            erasure_mask &= erasure_mask - 1;
+            ws.error_positions[e] = i;
+            X[e] = GF64(pow_table[(63 - i) % 63]);
+            omega_X[e] = odd[e] = GF64(0);
+            power[e] = X[e];
+        }
+        // omega(X) by Horner
+        for(int j = num_of_erasures - 1; j >= 0; j--) {
+            for(int e = 0; e < num_of_erasures; e++) omega_X[e] = omega_X[e] * X[e] + omega[j];
+        }
+        // X * Gamma'(X) is the sum of the odd terms Gamma_j * X^j
+        for(int j = 1; j <= num_of_erasures; j += 2) {
+            for(int e = 0; e < num_of_erasures; e++) {
+                odd[e] = odd[e] + gamma[j] * power[e];
+                power[e] = power[e] * X[e] * X[e];
+            }
+        }
+        // Gamma(x) has distinct roots, so Gamma'(X) != 0 (multiplying by the table inverse
+        // keeps the throwing division off the decode path)
+        for(int e = 0; e < num_of_erasures; e++) ws.error_values[e] = omega_X[e] * X[e] * odd[e].inverse();
+        ws.num_errors = num_of_erasures;
+        return true;
+    }
+
+    // Error correction: find the roots of Lambda(x) and their error values with Forney's formula
+    // Locators of degree >= transform_min_degree are evaluated at all 63 points with one
+    // GF64Transform (394 products instead of up to 63 * deg(Lambda) for the Chien search), and
+    // the frame is rejected before any Forney work unless deg(Lambda) points are roots.
+    // Both searches give the same positions (in increasing order) and values.
+    // Returns whether the frame is correctable.
+    // A shortened frame (message_length < 42) skips the implied zeros message_length~41.
+    bool correctErrors(DecoderWorkspace& ws, int message_length = k) {
+        ws.num_errors = 0;
+        // Time domain completion
+        // If the error locator polynomial is 0, the decoding fails
+        if(ws.locator.get_coefficient(0).get_value() == 0) {
+            return false;
+        }
+        int degree = ws.locator.get_degree();
+        // deg(w) < e_0 + deg(erasureLocator) = deg(Lambda)
+        if(ws.evaluator.get_degree() >= degree) {
+            return false;
+        }
+        if(degree >= transform_min_degree) return transformSearch(ws, degree, message_length);
+        return chienSearch(ws, degree, message_length);
+    }
+
+    // Fused Chien search and Forney algorithm
+    // Register j holds lambda_j * X^j at X = a^(-i) and moves on to position i + 1 with one
+    // multiplication by the constant a^(-j). At every position Lambda(X) is the sum of all
+    // registers and X * Lambda'(X) is the sum of the odd registers (1+1=0 in GF(64)), so the
+    // derivative comes for free. omega(X) is only needed at the roots, where it is evaluated
+    // directly (stepping its registers at all 63 positions would cost more than <= 21 evaluations).
+    // Only the (position, value) pairs of the roots are written to the workspace, and the
+    // search stops once deg(Lambda) roots are found. In a shortened frame the registers jump
+    // over the implied zeros with one multiplication by a^(-j * s).
+    bool chienSearch(DecoderWorkspace& ws, int degree, int message_length) {
+        GF64 lambda[64], lambda_step[64];
+        for(int j = 0; j <= degree; j++) {
+            lambda[j] = ws.locator.get_coefficient(j);
+            lambda_step[j] = GF64(pow_table[(63 - j) % 63]);
+        }
+        for(int i = 0; i < n && ws.num_errors < degree; i++) {
+            if(i == message_length && message_length < k) {
+                for(int j = 1; j <= degree; j++) lambda[j] = lambda[j] * GF64(pow_table[(63 - j) * (k - message_length) % 63]);
+                i = k;
+            }
+            GF64 even(0), odd(0);
+            for(int j = 0; j <= degree; j += 2) even = even + lambda[j];
+            for(int j = 1; j <= degree; j += 2) odd = odd + lambda[j];
+            // Lambda(X) = even + odd = 0 and Lambda'(X) != 0
+            if(even == odd && odd.get_value() != 0) {
+                // omega(X) / Lambda'(X) = X * omega(X) / (X * Lambda'(X))
+                GF64 X(pow_table[(63 - i) % 63]);
+                ws.error_positions[ws.num_errors] = i;
+                ws.error_values[ws.num_errors] = ws.evaluator(X) * X * odd.inverse();
+                ws.num_errors++;
+            }
+            for(int j = 1; j <= degree; j++) lambda[j] = lambda[j] * lambda_step[j];
+        }
+        // If the number of error is equal to the degree of the error locator polynomial, the error is correctable
+        return ws.num_errors == degree;
+    }
+
+    // Root search with the 63-point transform: values[k] = Lambda(a^k), position i is a root
+    // when Lambda(a^(-i)) = values[(63 - i) % 63] = 0. X * Lambda'(X) (the odd terms) and omega(X)
+    // are evaluated directly at the roots only.
+    bool transformSearch(DecoderWorkspace& ws, int degree, int message_length) {
+        uint8_t coefficients[64], values[63];
+        for(int j = 0; j <= degree; j++) coefficients[j] = ws.locator.get_coefficient(j).get_value();
+        GF64Transform::evaluate(coefficients, degree, values);
+        int roots = 0;
+        for(int i = 0; i < n; i++) {
+            if(i == message_length && message_length < k) i = k;
+            roots += values[(63 - i) % 63] == 0;
+        }
+        // A repeated root (Lambda'(X) = 0) makes the frame uncorrectable as well
+        if(roots != degree) return false;
+        for(int i = 0; i < n; i++) {
+            if(i == message_length && message_length < k) i = k;
+            if(values[(63 - i) % 63] != 0) continue;
+            GF64 X(pow_table[(63 - i) % 63]), X2 = X * X, odd(0), power = X;
+            for(int j = 1; j <= degree; j += 2, power = power * X2) odd = odd + ws.locator.get_coefficient(j) * power;
+            if(odd.get_value() == 0) return false;
+            ws.error_positions[ws.num_errors] = i;
+            ws.error_values[ws.num_errors] = ws.evaluator(X) * X * odd.inverse();
+            ws.num_errors++;
+        }
+        return true;
+    }
+
+    // Stages after the syndromes, the erasure locator and the Forney syndromes (all in the workspace,
+    // syndromes nonzero, at most 21 erasures): correct the codeword in place and return CORRECTED
+    // or UNCORRECTABLE. The erased symbols of codeword need not be 0 as long as the syndromes were
+    // computed with the same values: the values found at the erased positions are added to them.
+    // For a shortened frame (message_length < 42) erasure_mask and the workspace use the positions
+    // of the full code, and codeword is the shortened frame.
+    DecodeStatus correctFrame(uint64_t erasure_mask, uint8_t* codeword, DecoderWorkspace& ws,
+                              int message_length = k) {
+        RS_STATS_CLOCK(stats_clock);
+        // Frames with erasures but no errors skip the key equation and the Chien search
+        bool correctable = erasure_mask != 0 && correctErasures(erasure_mask, ws);
+        if(correctable) {
+            RS_STATS_STAGE(stats_clock, STAGE_CHIEN_FORNEY);
+        }
+        else {
+            // Solve the key equation, get error and erasure locator and error evaluator
+            if(key_equation_solver == KEY_EQUATION_BERLEKAMP_MASSEY) berlekampMasseyAlgorithm(ws);
+            else euclideanAlgorithm(ws);
+            RS_STATS_STAGE(stats_clock, STAGE_KEY_EQUATION);
+            // Error correction
+            correctable = correctErrors(ws, message_length);
+            RS_STATS_STAGE(stats_clock, STAGE_CHIEN_FORNEY);
+        }
+        if(!correctable) return DECODE_UNCORRECTABLE;
+        // codeword = received + error
+        for(int e = 0; e < ws.num_errors; e++) {
+            int position = ws.error_positions[e];
+            if(position >= k) position -= k - message_length;
+            codeword[position] ^= ws.error_values[e].get_value();
+        }
+        return DECODE_CORRECTED;
+    }
+
+public:
+    ReedSolomonDecoder(KeyEquationSolver solver = RS_KEY_EQUATION_SOLVER) {
+        key_equation_solver = solver;
+    }
+    // Select the algorithm that solves the key equation
+    void set_key_equation_solver(KeyEquationSolver solver) {
+        key_equation_solver = solver;
+    }
+    KeyEquationSolver get_key_equation_solver() const {
+        return key_equation_solver;
+    }
+
+    // Whether a symbol that is not erased is above 63 (the frame is DECODE_MALFORMED)
+    static bool has_invalid_symbols(const uint8_t* received, int length, uint64_t erasure_mask) {
+        uint8_t invalid = 0;
+        for(int i = 0; i < length; i++) invalid |= ((erasure_mask >> i) & 1) ? 0 : received[i];
+        return (invalid & ~63) != 0;
+    }
+
+    // Decode one frame without any heap allocation, exceptions or exits: every outcome is a DecodeStatus
+    // received holds 63 symbols, erasure_mask bit i marks symbol i as erased (its value is ignored)
+    // The 63 decoded symbols are written to codeword; frames that cannot be decoded are copied
+    // through with their erased symbols set to 0 (and the symbols of a malformed frame masked to 6 bits)
+    DecodeStatus decode_frame(const uint8_t* received, uint64_t erasure_mask, uint8_t* codeword,
+                              DecoderWorkspace& ws) {
+        // Per-stage cycle counters, compiled out unless RS_DECODER_STATS is defined (see rs_stats.h)
+        RS_STATS_START(stats_start, stats_clock);
+        erasure_mask &= (1ULL << n) - 1;
+        uint8_t invalid = 0;
+        for(int i = 0; i < n; i++) {
+            uint8_t symbol = ((erasure_mask >> i) & 1) ? 0 : received[i];
+            invalid |= symbol;
+            codeword[i] = symbol & 63;
+        }
+        if(invalid & ~63) return RS_STATS_RESULT(DECODE_MALFORMED, stats_start);
+        // Calculate syndromes
+        calculateSyndromes(codeword, ws.syndromes);
+        RS_STATS_STAGE(stats_clock, STAGE_SYNDROMES);
+        if(ws.syndromes.is_zero()) return RS_STATS_RESULT(DECODE_OK, stats_start);
+        // More than 21 erasures cannot be decoded
+        if(__builtin_popcountll(erasure_mask) > 21) return RS_STATS_RESULT(DECODE_TOO_MANY_ERASURES, stats_start);
+        // Calculate erasure locator polynomial
+        calculateErasureLocator(erasure_mask, ws.erasure_locator);
+        calculateForneySyndromes(ws);
+        RS_STATS_STAGE(stats_clock, STAGE_ERASURE_LOCATOR);
+        return RS_STATS_RESULT(correctFrame(erasure_mask, codeword, ws), stats_start);
+    }
+
+    // Decode one shortened RS(63-s, 42-s) frame: received holds length = 63 - s symbols (22~63),
+    // the 42 - s message symbols followed by the 21 parity symbols, as written by
+    // ReedSolomonEncoder::encodeShortened. Bit i of erasure_mask marks symbol i of the frame.
+    // The s implied zero symbols are neither stored nor read, and the syndromes and the Chien
+    // search only visit the length stored positions. length = 63 is the same as decode_frame.
+    // A length outside 22~63 is DECODE_MALFORMED, and codeword is left untouched.
+    DecodeStatus decode_shortened(const uint8_t* received, int length, uint64_t erasure_mask, uint8_t* codeword,
+                                  DecoderWorkspace& ws) {
+        RS_STATS_START(stats_start, stats_clock);
+        if(length < n - k + 1 || length > n) return RS_STATS_RESULT(DECODE_MALFORMED, stats_start);
+        int message_length = length - (n - k);
+        erasure_mask &= (1ULL << length) - 1;
+        uint8_t invalid = 0;
+        for(int i = 0; i < length; i++) {
+            uint8_t symbol = ((erasure_mask >> i) & 1) ? 0 : received[i];
+            invalid |= symbol;
+            codeword[i] = symbol & 63;
+        }
+        if(invalid & ~63) return RS_STATS_RESULT(DECODE_MALFORMED, stats_start);
+        alignas(32) uint8_t values[32];
+        syndrome_engine->compute_shortened(codeword, message_length, values);
+        loadSyndromes(values, ws.syndromes);
+        RS_STATS_STAGE(stats_clock, STAGE_SYNDROMES);
+        if(ws.syndromes.is_zero()) return RS_STATS_RESULT(DECODE_OK, stats_start);
+        if(__builtin_popcountll(erasure_mask) > 21) return RS_STATS_RESULT(DECODE_TOO_MANY_ERASURES, stats_start);
+        // The parity erasures move to the full code positions 42~62
+        uint64_t message_mask = (1ULL << message_length) - 1;
+        uint64_t full_mask = (erasure_mask & message_mask) | ((erasure_mask >> message_length) << k);
+        calculateErasureLocator(full_mask, ws.erasure_locator);
+        calculateForneySyndromes(ws);
+        RS_STATS_STAGE(stats_clock, STAGE_ERASURE_LOCATOR);
+        return RS_STATS_RESULT(correctFrame(full_mask, codeword, ws, message_length), stats_start);
+    }
+
+    // Decode a received word of 63 GF64 symbols (erasures[i] marks symbol i as erased) into decoded
+    // A word that is not 63 symbols long or holds a value above 63 is DECODE_MALFORMED (decoded
+    // is then left untouched); the other outcomes are those of decode_frame
+    DecodeStatus decode(const std::vector<GF64>& received, const std::vector<bool>& erasures, GF64_poly& decoded) {
+        if(received.size() != (size_t)n) return DECODE_MALFORMED;
+        uint8_t symbols[n], codeword[n];
+        uint64_t erasure_mask = 0;
+        for(int i = 0; i < n; i++) {
+            int value = received[i].get_value();
+            bool erased = i < (int)erasures.size() && erasures[i];
+            if(!erased && (value < 0 || value > 63)) return DECODE_MALFORMED;
+            symbols[i] = erased ? 0 : value;
+            if(erased) erasure_mask |= 1ULL << i;
+        }
+        DecoderWorkspace ws;
+        DecodeStatus status = decode_frame(symbols, erasure_mask, codeword, ws);
+        std::vector<GF64> result(n);
+        for(int i = 0; i < n; i++) result[i] = GF64(codeword[i]);
+        decoded = GF64_poly(result);
+        return status;
+    }
+    // Same, with only whether the word was decoded (OK or CORRECTED)
+    std::pair<bool, GF64_poly> decode(const std::vector<GF64>& received,
+                            const std::vector<bool>& erasures = std::vector<bool>()) {
+        GF64_poly decoded;
+        DecodeStatus status = decode(received, erasures, decoded);
+        return std::make_pair(status == DECODE_OK || status == DECODE_CORRECTED, decoded);
+    }
+
+    // Decode count frames stored back to back with the given stride (>= 63 symbols per frame)
+    // erasure_masks[f] bit i marks symbol i of frame f as erased (the symbol value is ignored)
+    // The decoded frames are written to corrected and the result of each frame to status;
+    // frames that cannot be decoded are copied through with their erased symbols set to 0
+    void decode_batch(const uint8_t* symbols, const uint64_t* erasure_masks, size_t count,
+                      uint8_t* corrected, uint8_t* status, size_t stride = CodewordBatch::stride) {
+        // One workspace is shared by every frame of the batch
+        DecoderWorkspace ws;
+        for(size_t f = 0; f < count; f++) {
+            status[f] = decode_frame(symbols + f * stride, erasure_masks[f], corrected + f * stride, ws);
+        }
+    }
+
+    // Decode every frame of a CodewordBatch in place of its corrected and status arrays
+    void decode_batch(CodewordBatch& batch) {
+        decode_batch(batch.symbols, batch.erasure_masks, batch.count, batch.corrected, batch.status);
+    }
+};
+
+#endif
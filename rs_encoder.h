@@ -0,0 +1,222 @@
+#ifndef RS_ENCODER_H
+#define RS_ENCODER_H
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+#include "gf64.h"
+#include "gf64_poly.h"
+#include "rs_codec.h"
+
+// Coefficients of the generator polynomial for the Reed-Solomon code (generated at compile time)
+inline constexpr std::array<uint8_t, RS63_42::parity + 1> gen_poly = RS63_42::generator;
+static_assert(gen_poly[0] == 58 && gen_poly[1] == 62 && gen_poly[20] == 44 && gen_poly[21] == 1,
+              "generator polynomial mismatch");
+
+class ReedSolomonEncoder {
+private:
+    static const int n = RS63_42::n;  // Code length
+    static const int k = RS63_42::k;  // Message length
+    static const int t = RS63_42::t;  // Error correction capability
+
+public:
+    // Create generator polynomial
+    GF64_poly createGeneratorPolynomial() {
+        std::vector<GF64> gen_coeffs(22);
+        for(int i = 0; i < 22; i++) {
+            gen_coeffs[i] = GF64(gen_poly[i]);
+        }
+        return GF64_poly(gen_coeffs);
+    }
+    // Encode a message into a codeword
+    
+    std::vector<GF64> encode(const std::vector<GF64>& message) {
+        if (message.size() != k) {
+            throw std::invalid_argument("Message length must be " + std::to_string(k));
+        }
+        
+        // Create message polynomial
+        GF64_poly message_poly(message);
+        
+        // Create generator polynomial
+        GF64_poly gen_poly = createGeneratorPolynomial();
+        
+        // Multiply polynomials
+        GF64_poly codeword_poly = message_poly * gen_poly;
+        
+        // Convert to vector and ensure length is n (missing high terms are 0)
+        std::vector<GF64> codeword(n);
+        for (int i = 0; i < n; i++) codeword[i] = codeword_poly.get_coefficient(i);
+        
+        return codeword;
+    }
+
+    // Systematic encoding with a 21-stage shift register that divides by gen_poly
+    // The codeword is the 42 message symbols followed by the 21 parity symbols, no heap is used.
+    // The register computes parity(x) = x^21 * message(x) mod gen_poly(x), so parity(x) + x^21 * message(x)
+    // is a codeword; RS codes are cyclic, and rotating it by 42 positions puts the message at
+    // positions 0~41 and the parity at 42~62
+    void encodeSystematic(const uint8_t* message, uint8_t* codeword) const {
+        encodeShortened(message, k, codeword);
+    }
+
+    // Shortened RS(63-s, 42-s) encoding, message_length = 42 - s (1~42)
+    // The s implied message symbols message_length~41 are zero: they would only shift zeros through
+    // the register, so the register starts at the last real symbol. The codeword is the
+    // message_length message symbols followed by the 21 parity symbols (63 - s in total), the
+    // same as the full codeword of the zero-padded message with the zeros left out.
+    // Message symbols are taken modulo 64, like the table encoder does.
+    void encodeShortened(const uint8_t* message, int message_length, uint8_t* codeword) const {
+        uint8_t parity[21] = {0};
+        // Feed the message from the highest degree term
+        for (int i = message_length - 1; i >= 0; i--) {
+            GF64 feedback = GF64(message[i] & 63) + GF64(parity[20]);
+            for (int j = 20; j > 0; j--) {
+                parity[j] = (GF64(parity[j - 1]) + feedback * GF64(gen_poly[j])).get_value();
+            }
+            parity[0] = (feedback * GF64(gen_poly[0])).get_value();
+        }
+        for (int i = 0; i < message_length; i++) codeword[i] = message[i] & 63;
+        for (int j = 0; j < n - k; j++) codeword[message_length + j] = parity[j];
+    }
+
+    std::vector<GF64> encodeSystematic(const std::vector<GF64>& message) const {
+        if (message.size() != k) {
+            throw std::invalid_argument("Message length must be " + std::to_string(k));
+        }
+        uint8_t symbols[k], codeword_symbols[n];
+        for (int i = 0; i < k; i++) symbols[i] = message[i].get_value();
+        encodeSystematic(symbols, codeword_symbols);
+        std::vector<GF64> codeword(n);
+        for (int i = 0; i < n; i++) codeword[i] = GF64(codeword_symbols[i]);
+        return codeword;
+    }
+
+    // Encode a message from raw integers
+    std::vector<GF64> encodeFromInts(const std::vector<int>& message, bool systematic = false) {
+        if (message.size() != k) {
+            throw std::invalid_argument("Message length must be " + std::to_string(k));
+        }
+
+        std::vector<GF64> gfMessage;
+        for (int value : message) {
+            gfMessage.push_back(GF64(value));
+        }
+        
+        return systematic ? encodeSystematic(gfMessage) : encode(gfMessage);
+    }
+};
+
+// Check that a word is a codeword: the remainder of the division by the generator polynomial is zero
+inline bool verify_codeword(const std::vector<GF64>& codeword) {
+    // Create generator polynomial
+    std::vector<GF64> gen_poly_coeffs(gen_poly.begin(), gen_poly.end());
+    GF64_poly generator(gen_poly_coeffs);
+    
+    // Create codeword polynomial
+    GF64_poly codeword_poly(codeword);
+    
+    // Divide codeword by generator polynomial
+    GF64_poly remainder = codeword_poly % generator;
+    
+    // Check if remainder is zero
+    return remainder.is_zero();
+}
+
+// Table-driven systematic encoder for bulk encoding
+// The parity of a systematic codeword is linear in the message, so it is the XOR of the parity
+// contributions of every (message position, symbol value) pair. These 42 x 64 contributions are
+// precomputed as 32-byte rows (21 parity symbols + padding, 84 KB in total), and encoding a
+// message takes 42 row XORs, one AVX2 or two SSE2 instructions each.
+class BatchEncoder {
+    private:
+        static const int n = RS63_42::n;  // Code length
+        static const int k = RS63_42::k;  // Message length
+        alignas(32) uint8_t parity_table[k][64][32];
+
+        // Encode the messages [begin, end)
+        void encode_range(const uint8_t* messages, uint8_t* codewords, size_t begin, size_t end,
+                          size_t message_stride, size_t codeword_stride) const {
+            for (size_t f = begin; f < end; f++) {
+                encode(messages + f * message_stride, codewords + f * codeword_stride);
+            }
+        }
+    public:
+        BatchEncoder() {
+            ReedSolomonEncoder encoder;
+            uint8_t message[k] = {0}, codeword[n];
+            for (int i = 0; i < k; i++) {
+                for (int value = 0; value < 64; value++) {
+                    message[i] = value;
+                    encoder.encodeSystematic(message, codeword);
+                    for (int j = 0; j < 32; j++) parity_table[i][value][j] = j < n - k ? codeword[k + j] : 0;
+                }
+                message[i] = 0;
+            }
+        }
+        BatchEncoder(const BatchEncoder&) = delete;
+        BatchEncoder& operator=(const BatchEncoder&) = delete;
+        // The shared table, built on first use
+        static const BatchEncoder& instance() {
+            static const BatchEncoder* encoder = new BatchEncoder();
+            return *encoder;
+        }
+
+        // Systematic encoding of one message, same output as encodeSystematic
+        // Message symbols are taken modulo 64, in the parity and in the copied message alike
+        // A message_length below 42 encodes the shortened code, like encodeShortened
+        void encode(const uint8_t* message, uint8_t* codeword, int message_length = k) const {
+            alignas(32) uint8_t parity[32];
+#if defined(__AVX2__)
+            __m256i acc = _mm256_setzero_si256();
+            for (int i = 0; i < message_length; i++) {
+                acc = _mm256_xor_si256(acc, _mm256_load_si256((const __m256i*)parity_table[i][message[i] & 63]));
+            }
+            _mm256_store_si256((__m256i*)parity, acc);
+#elif defined(__SSE2__)
+            __m128i acc0 = _mm_setzero_si128(), acc1 = _mm_setzero_si128();
+            for (int i = 0; i < message_length; i++) {
+                const uint8_t* row = parity_table[i][message[i] & 63];
+                acc0 = _mm_xor_si128(acc0, _mm_load_si128((const __m128i*)row));
+                acc1 = _mm_xor_si128(acc1, _mm_load_si128((const __m128i*)(row + 16)));
+            }
+            _mm_store_si128((__m128i*)parity, acc0);
+            _mm_store_si128((__m128i*)(parity + 16), acc1);
+#else
+            for (int j = 0; j < 32; j++) parity[j] = 0;
+            for (int i = 0; i < message_length; i++) {
+                const uint8_t* row = parity_table[i][message[i] & 63];
+                for (int j = 0; j < 32; j++) parity[j] ^= row[j];
+            }
+#endif
+            for (int i = 0; i < message_length; i++) codeword[i] = message[i] & 63;
+            for (int j = 0; j < n - k; j++) codeword[message_length + j] = parity[j];
+        }
+
+        // Encode count messages stored back to back, message_stride >= 42 and codeword_stride >= 63
+        // The messages are split into contiguous chunks over the given number of threads
+        void encode_batch(const uint8_t* messages, size_t count, uint8_t* codewords,
+                          size_t message_stride = k, size_t codeword_stride = 64, int threads = 1) const {
+            if (threads <= 1 || count < (size_t)threads) {
+                encode_range(messages, codewords, 0, count, message_stride, codeword_stride);
+                return;
+            }
+            std::vector<std::thread> workers;
+            size_t chunk = (count + threads - 1) / threads;
+            for (int t = 0; t < threads; t++) {
+                size_t begin = t * chunk, end = std::min(count, begin + chunk);
+                if (begin >= end) break;
+                workers.emplace_back(&BatchEncoder::encode_range, this, messages, codewords, begin, end,
+                                     message_stride, codeword_stride);
+            }
+            for (auto& worker : workers) worker.join();
+        }
+};
+
+#endif
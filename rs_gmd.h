@@ -0,0 +1,141 @@
+#ifndef RS_GMD_H
+#define RS_GMD_H
+
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+#include "rs_decoder.h"
+
+// Generalized minimum distance (soft-input) decoding
+// Besides the hard erasures, every symbol has a reliability from the demodulator (higher is
+// more reliable). Trial t erases the 2t least reliable remaining symbols, t = 0, 1, 2, ... while
+// at most 21 symbols are erased, and the first trial that decodes wins.
+// The trials share almost all of their work. The erased symbols keep their received values
+// (the decoder adds the values it finds at the erased positions to them), so the syndromes
+// S(x) are computed once. Every new erasure at position i multiplies both the erasure locator
+// Gamma(x) and the Forney syndromes T(x) = Gamma(x) S(x) mod x^21 by (1 + a^i x), O(21) each,
+// and a trial only runs the key equation and the Chien/Forney stage.
+class GMDDecoder {
+    private:
+        ReedSolomonDecoder& decoder;
+        DecoderWorkspace ws;
+
+        // P(x) = P(x) * (1 + a^i x), keeping the terms below x^size
+        static void multiply_by_root(GF64* p, int& degree, int size, int position) {
+            GF64 alpha(pow_table[position]);
+            int top = std::min(degree + 1, size - 1);
+            if(top > degree) p[top] = GF64(0);
+            for(int j = top; j > 0; j--) p[j] = p[j] + p[j - 1] * alpha;
+            degree = top;
+        }
+        // Write the count least reliable symbols outside erasure_mask to order, least reliable first
+        // (ties go to the lower position). The rank of a symbol is the number of symbols with a
+        // smaller key, counted without branches: a comparison sort of 63 floats mispredicts most
+        // of its branches and costs more than a trial. A key is the reliability as an order
+        // preserving integer (the 6 lowest mantissa bits dropped) with the position below it.
+        static void least_reliable(const float* reliability, uint64_t erasure_mask, int count, int* order) {
+            alignas(32) int32_t keys[64];
+            for(int i = 0; i < 63; i++) {
+                uint32_t bits;
+                memcpy(&bits, &reliability[i], 4);
+                bits ^= (uint32_t)((int32_t)bits >> 31) | 0x80000000u;
+                keys[i] = ((erasure_mask >> i) & 1) ? INT32_MAX : (int32_t)((((bits >> 6) << 6) | i) ^ 0x80000000u);
+            }
+            keys[63] = INT32_MAX;
+            for(int i = 0; i < 63; i++) {
+                if((erasure_mask >> i) & 1) continue;
+                int rank = 0;
+#if defined(__AVX2__)
+                __m256i key = _mm256_set1_epi32(keys[i]), smaller = _mm256_setzero_si256();
+                for(int j = 0; j < 64; j += 8) {
+                    // key > keys[j] is -1, so subtracting counts the smaller keys
+                    smaller = _mm256_sub_epi32(smaller, _mm256_cmpgt_epi32(key, _mm256_load_si256((const __m256i*)&keys[j])));
+                }
+                __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(smaller), _mm256_extracti128_si256(smaller, 1));
+                sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4E));
+                sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xB1));
+                rank = _mm_cvtsi128_si32(sum);
+#else
+                for(int j = 0; j < 64; j++) rank += keys[j] < keys[i];
+#endif
+                if(rank < count) order[rank] = i;
+            }
+        }
+        static void load(GF64_fixed_poly& poly, const GF64* p, int degree) {
+            poly.clear();
+            for(int j = degree; j >= 0; j--) {
+                if(p[j].get_value() != 0) poly.set_coefficients(j, p[j]);
+            }
+        }
+
+    public:
+        explicit GMDDecoder(ReedSolomonDecoder& decoder) : decoder(decoder) {}
+
+        // Decode one frame: received holds 63 symbols, reliability 63 values (higher = more reliable),
+        // bit i of erasure_mask marks symbol i as erased in every trial. The decoded symbols are
+        // written to codeword (frames that cannot be decoded are copied through with their hard
+        // erasures set to 0). trials, if given, receives the number of trials that were run.
+        DecodeStatus decode(const uint8_t* received, const float* reliability, uint64_t erasure_mask,
+                            uint8_t* codeword, int* trials = nullptr) {
+            RS_STATS_START(stats_start, stats_clock);
+            const int n = RS63_42::n, parity = RS63_42::parity;
+            if(trials != nullptr) *trials = 0;
+            erasure_mask &= (1ULL << n) - 1;
+            for(int i = 0; i < n; i++) {
+                codeword[i] = ((erasure_mask >> i) & 1) ? 0 : (received[i] & 63);
+            }
+            if(ReedSolomonDecoder::has_invalid_symbols(received, n, erasure_mask)) {
+                return RS_STATS_RESULT(DECODE_MALFORMED, stats_start);
+            }
+            // Syndromes of the received word, computed once for all trials
+            decoder.calculateSyndromes(codeword, ws.syndromes);
+            RS_STATS_STAGE(stats_clock, STAGE_SYNDROMES);
+            if(trials != nullptr) *trials = 1;
+            if(ws.syndromes.is_zero()) return RS_STATS_RESULT(DECODE_OK, stats_start);
+            // Same order as decode_frame: a zero-syndrome frame is OK whatever its erasures
+            int num_erasures = __builtin_popcountll(erasure_mask);
+            if(num_erasures > parity) return RS_STATS_RESULT(DECODE_TOO_MANY_ERASURES, stats_start);
+            // Number of symbols the trials may erase on top of the hard erasures
+            int extra = std::min(n - num_erasures, (parity - num_erasures) & ~1);
+            int candidates[parity];
+            // Gamma(x) and T(x) of the hard erasures
+            GF64 gamma[parity + 1], forney[parity];
+            int gamma_degree = 0, forney_degree = parity - 1;
+            gamma[0] = GF64(1);
+            for(uint64_t mask = erasure_mask; mask != 0; mask &= mask - 1) {
+                multiply_by_root(gamma, gamma_degree, parity + 1, __builtin_ctzll(mask));
+            }
+            for(int j = 0; j < parity; j++) {
+                GF64 T(0);
+                for(int l = 0; l <= j && l <= gamma_degree; l++) T = T + gamma[l] * ws.syndromes.get_coefficient(j - l);
+                forney[j] = T;
+            }
+            RS_STATS_STAGE(stats_clock, STAGE_ERASURE_LOCATOR);
+            DecodeStatus status = DECODE_UNCORRECTABLE;
+            uint64_t trial_mask = erasure_mask;
+            for(int erased = 0; erased <= extra; erased += 2) {
+                if(erased > 0) {
+                    // The first trial is a plain decode, the ranking is only needed when it fails
+                    if(erased == 2) least_reliable(reliability, erasure_mask, extra, candidates);
+                    for(int c = erased - 2; c < erased; c++) {
+                        multiply_by_root(gamma, gamma_degree, parity + 1, candidates[c]);
+                        multiply_by_root(forney, forney_degree, parity, candidates[c]);
+                        trial_mask |= 1ULL << candidates[c];
+                    }
+                    if(trials != nullptr) (*trials)++;
+                }
+                load(ws.erasure_locator, gamma, gamma_degree);
+                load(ws.forney_syndromes, forney, forney_degree);
+                status = decoder.correctFrame(trial_mask, codeword, ws);
+                if(status == DECODE_CORRECTED) break;
+            }
+            // A failed frame is passed through (hard erasures set to 0, trial erasures as received)
+            return RS_STATS_RESULT(status, stats_start);
+        }
+};
+
+#endif
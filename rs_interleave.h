@@ -0,0 +1,211 @@
+#ifndef RS_INTERLEAVE_H
+#define RS_INTERLEAVE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+#include "rs_decoder.h"
+#include "rs_encoder.h"
+
+// Byte matrix transpose: dst[c * dst_stride + r] = src[r * src_stride + c], r < rows, c < cols
+// The matrix is walked in 64 x 64 blocks (one block of the source and of the destination fit in
+// L1 together) made of 8 x 8 tiles, each transposed in registers with three rounds of unpacks;
+// the ragged edges are copied one byte at a time.
+inline void transpose_symbols(const uint8_t* src, size_t src_stride, uint8_t* dst, size_t dst_stride,
+                              size_t rows, size_t cols) {
+    const size_t block = 64;
+    for(size_t r0 = 0; r0 < rows; r0 += block) {
+        size_t r_end = std::min(rows, r0 + block);
+        for(size_t c0 = 0; c0 < cols; c0 += block) {
+            size_t c_end = std::min(cols, c0 + block);
+            size_t r = r0;
+#if defined(__SSE2__)
+            for(; r + 8 <= r_end; r += 8) {
+                size_t c = c0;
+                for(; c + 8 <= c_end; c += 8) {
+                    const uint8_t* s = src + r * src_stride + c;
+                    __m128i r0 = _mm_loadl_epi64((const __m128i*)(s));
+                    __m128i r1 = _mm_loadl_epi64((const __m128i*)(s + src_stride));
+                    __m128i r2 = _mm_loadl_epi64((const __m128i*)(s + 2 * src_stride));
+                    __m128i r3 = _mm_loadl_epi64((const __m128i*)(s + 3 * src_stride));
+                    __m128i r4 = _mm_loadl_epi64((const __m128i*)(s + 4 * src_stride));
+                    __m128i r5 = _mm_loadl_epi64((const __m128i*)(s + 5 * src_stride));
+                    __m128i r6 = _mm_loadl_epi64((const __m128i*)(s + 6 * src_stride));
+                    __m128i r7 = _mm_loadl_epi64((const __m128i*)(s + 7 * src_stride));
+                    // Pairs of rows, then quads: after the last round every 8 bytes are one column
+                    __m128i a = _mm_unpacklo_epi8(r0, r1), b = _mm_unpacklo_epi8(r2, r3);
+                    __m128i e = _mm_unpacklo_epi8(r4, r5), f = _mm_unpacklo_epi8(r6, r7);
+                    __m128i ab_lo = _mm_unpacklo_epi16(a, b), ab_hi = _mm_unpackhi_epi16(a, b);
+                    __m128i ef_lo = _mm_unpacklo_epi16(e, f), ef_hi = _mm_unpackhi_epi16(e, f);
+                    __m128i c01 = _mm_unpacklo_epi32(ab_lo, ef_lo), c23 = _mm_unpackhi_epi32(ab_lo, ef_lo);
+                    __m128i c45 = _mm_unpacklo_epi32(ab_hi, ef_hi), c67 = _mm_unpackhi_epi32(ab_hi, ef_hi);
+                    uint8_t* d = dst + c * dst_stride + r;
+                    _mm_storel_epi64((__m128i*)(d), c01);
+                    _mm_storel_epi64((__m128i*)(d + dst_stride), _mm_unpackhi_epi64(c01, c01));
+                    _mm_storel_epi64((__m128i*)(d + 2 * dst_stride), c23);
+                    _mm_storel_epi64((__m128i*)(d + 3 * dst_stride), _mm_unpackhi_epi64(c23, c23));
+                    _mm_storel_epi64((__m128i*)(d + 4 * dst_stride), c45);
+                    _mm_storel_epi64((__m128i*)(d + 5 * dst_stride), _mm_unpackhi_epi64(c45, c45));
+                    _mm_storel_epi64((__m128i*)(d + 6 * dst_stride), c67);
+                    _mm_storel_epi64((__m128i*)(d + 7 * dst_stride), _mm_unpackhi_epi64(c67, c67));
+                }
+                for(; c < c_end; c++) {
+                    for(size_t i = r; i < r + 8; i++) dst[c * dst_stride + i] = src[i * src_stride + c];
+                }
+            }
+#endif
+            for(; r < r_end; r++) {
+                for(size_t c = c0; c < c_end; c++) dst[c * dst_stride + r] = src[r * src_stride + c];
+            }
+        }
+    }
+}
+
+// Depth-D interleaved RS(63,42) codec for burst channels
+// A block is D codewords sent symbol by symbol: channel symbol j * D + c is symbol j of codeword c,
+// so a burst of B symbols puts at most ceil(B / D) errors into each codeword and bursts up to
+// about 10 * D symbols (21 * D if they are flagged as erasures) are corrected.
+// Decoding de-interleaves the block and its erasure flags into a CodewordBatch and runs
+// decode_batch on all D codewords. If some codewords fail, the others show where the bursts are:
+// every symbol they corrected (and every flagged symbol) is a hit, and a symbol of a failed
+// codeword that lies inside a burst (a hit within D channel symbols on both sides) is erased.
+// The failed codewords are decoded again as one batch, and this repeats while it helps.
+// One codec per thread.
+class InterleavedCodec {
+    private:
+        static const int n = RS63_42::n;
+        static const int k = RS63_42::k;
+        static const int max_rounds = 3;   // Erasure propagation rounds after the first decode
+        int depth;
+        const BatchEncoder& encoder;       // Shared read-only tables (BatchEncoder::instance())
+        ReedSolomonDecoder decoder;
+        CodewordBatch batch, retry;
+        std::vector<uint8_t> flags;        // De-interleaved erasure flags, depth x 64
+        std::vector<uint8_t> hits;         // Channel symbols known to be in a burst
+        std::vector<int> previous_hit, next_hit;
+        std::vector<int> failed, retried;   // Codewords that failed, and the ones in the retry batch
+
+        // Bit i of the mask is set when flag i is nonzero
+        static uint64_t flags_to_mask(const uint8_t* flag) {
+            uint64_t mask = 0;
+#if defined(__SSE2__)
+            __m128i zero = _mm_setzero_si128();
+            for(int i = 0; i < 64; i += 16) {
+                __m128i is_zero = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(flag + i)), zero);
+                mask |= (uint64_t)(~_mm_movemask_epi8(is_zero) & 0xFFFF) << i;
+            }
+#else
+            for(int i = 0; i < 64; i++) mask |= (uint64_t)(flag[i] != 0) << i;
+#endif
+            return mask & ((1ULL << n) - 1);
+        }
+
+        // Mark the symbols that codeword c changed as hits
+        void mark_hits(int c, const uint8_t* received, const uint8_t* decoded, uint64_t erasure_mask) {
+            for(int j = 0; j < n; j++) {
+                if(received[j] != decoded[j] || ((erasure_mask >> j) & 1)) hits[j * depth + c] = 1;
+            }
+        }
+
+        // Distance from every channel symbol to the nearest hit before and after it
+        void measure_hits() {
+            int size = depth * n, last = -size;
+            for(int p = 0; p < size; p++) {
+                if(hits[p]) last = p;
+                previous_hit[p] = p - last;
+            }
+            last = 2 * size;
+            for(int p = size - 1; p >= 0; p--) {
+                if(hits[p]) last = p;
+                next_hit[p] = last - p;
+            }
+        }
+
+    public:
+        explicit InterleavedCodec(int depth, KeyEquationSolver solver = RS_KEY_EQUATION_SOLVER)
+            : depth(depth < 1 ? 1 : depth), encoder(BatchEncoder::instance()), decoder(solver),
+              batch(this->depth), retry(this->depth), flags(this->depth * 64, 0),
+              hits(this->depth * n), previous_hit(this->depth * n), next_hit(this->depth * n) {}
+        InterleavedCodec(const InterleavedCodec&) = delete;
+        InterleavedCodec& operator=(const InterleavedCodec&) = delete;
+
+        int get_depth() const { return depth; }
+        // Channel symbols per block
+        int block_size() const { return depth * n; }
+
+        // Encode depth messages (42 symbols each, stored back to back) into one block of depth * 63
+        // channel symbols
+        void encode(const uint8_t* messages, uint8_t* block) {
+            encoder.encode_batch(messages, depth, batch.symbols, k, CodewordBatch::stride);
+            transpose_symbols(batch.symbols, CodewordBatch::stride, block, depth, depth, n);
+        }
+
+        // Decode one block: erased (may be null) flags erased channel symbols with nonzero bytes.
+        // The depth decoded codewords are written to codewords (64 bytes each, symbol 63 is 0) and
+        // their results to status; returns the number of codewords that could not be decoded.
+        int decode(const uint8_t* block, const uint8_t* erased, uint8_t* codewords, uint8_t* status) {
+            transpose_symbols(block, depth, batch.symbols, CodewordBatch::stride, n, depth);
+            if(erased != nullptr) {
+                transpose_symbols(erased, depth, flags.data(), 64, n, depth);
+                for(int c = 0; c < depth; c++) batch.erasure_masks[c] = flags_to_mask(&flags[c * 64]);
+            }
+            else std::fill(batch.erasure_masks, batch.erasure_masks + depth, 0);
+            decoder.decode_batch(batch);
+
+            failed.clear();
+            std::fill(hits.begin(), hits.end(), 0);
+            for(int c = 0; c < depth; c++) {
+                DecodeStatus result = (DecodeStatus)batch.status[c];
+                if(result == DECODE_OK || result == DECODE_CORRECTED) {
+                    mark_hits(c, batch.frame(c), batch.corrected_frame(c), batch.erasure_masks[c]);
+                }
+                else {
+                    // Only the flagged symbols of a failed codeword are known hits
+                    failed.push_back(c);
+                    mark_hits(c, batch.frame(c), batch.frame(c), batch.erasure_masks[c]);
+                }
+            }
+            // Propagate the bursts found by the decoded codewords to the failed ones
+            for(int round = 0; round < max_rounds && !failed.empty(); round++) {
+                measure_hits();
+                // Retry the failed codewords that get new erasures, as one batch
+                retried.clear();
+                for(int c : failed) {
+                    uint64_t mask = batch.erasure_masks[c];
+                    for(int j = 0; j < n; j++) {
+                        int p = j * depth + c;
+                        if(previous_hit[p] <= depth && next_hit[p] <= depth) mask |= 1ULL << j;
+                    }
+                    if(mask == batch.erasure_masks[c]) continue;
+                    memcpy(retry.frame(retried.size()), batch.frame(c), CodewordBatch::stride);
+                    retry.erasure_masks[retried.size()] = mask;
+                    retried.push_back(c);
+                }
+                if(retried.empty()) break;
+                decoder.decode_batch(retry.symbols, retry.erasure_masks, retried.size(), retry.corrected, retry.status);
+                bool progress = false;
+                for(size_t r = 0; r < retried.size(); r++) {
+                    DecodeStatus result = (DecodeStatus)retry.status[r];
+                    if(result != DECODE_OK && result != DECODE_CORRECTED) continue;
+                    int c = retried[r];
+                    memcpy(batch.corrected_frame(c), retry.corrected_frame(r), CodewordBatch::stride);
+                    batch.status[c] = result;
+                    mark_hits(c, batch.frame(c), batch.corrected_frame(c), retry.erasure_masks[r]);
+                    failed.erase(std::find(failed.begin(), failed.end(), c));
+                    progress = true;
+                }
+                if(!progress) break;
+            }
+            for(int c = 0; c < depth; c++) {
+                memcpy(codewords + c * 64, batch.corrected_frame(c), 64);
+                status[c] = batch.status[c];
+            }
+            return (int)failed.size();
+        }
+};
+
+#endif
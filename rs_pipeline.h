@@ -0,0 +1,344 @@
+#ifndef RS_PIPELINE_H
+#define RS_PIPELINE_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include "rs_decoder.h"
+#include "rs_text.h"
+#include "rs_wire.h"
+
+// Bounded lock-free multi-producer multi-consumer queue (ring buffer with one sequence number per cell)
+// A cell is free for the producer at position pos when its sequence is pos, and holds data for the
+// consumer at position pos when its sequence is pos + 1. The capacity is rounded up to a power of two.
+template<typename T>
+class BoundedQueue {
+    private:
+        struct Cell {
+            std::atomic<size_t> sequence;
+            T data;
+        };
+        std::vector<Cell> cells;
+        size_t mask;
+        // Producer and consumer positions on separate cache lines
+        alignas(64) std::atomic<size_t> enqueue_position;
+        alignas(64) std::atomic<size_t> dequeue_position;
+
+        // Spin a little, then give the core away (the pipeline may have more threads than cores)
+        static void backoff(int& spins) {
+            if(++spins < 64) return;
+            std::this_thread::yield();
+        }
+
+    public:
+        BoundedQueue(size_t capacity) {
+            size_t size = 2;
+            while(size < capacity) size <<= 1;
+            cells = std::vector<Cell>(size);
+            mask = size - 1;
+            for(size_t i = 0; i < size; i++) cells[i].sequence.store(i, std::memory_order_relaxed);
+            enqueue_position.store(0, std::memory_order_relaxed);
+            dequeue_position.store(0, std::memory_order_relaxed);
+        }
+        BoundedQueue(const BoundedQueue&) = delete;
+        BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+        // Returns false if the queue is full
+        bool try_push(const T& value) {
+            size_t position = enqueue_position.load(std::memory_order_relaxed);
+            for(;;) {
+                Cell& cell = cells[position & mask];
+                size_t sequence = cell.sequence.load(std::memory_order_acquire);
+                intptr_t difference = (intptr_t)sequence - (intptr_t)position;
+                if(difference == 0) {
+                    if(enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                        cell.data = value;
+                        cell.sequence.store(position + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if(difference < 0) return false;
+                else position = enqueue_position.load(std::memory_order_relaxed);
+            }
+        }
+        // Returns false if the queue is empty
+        bool try_pop(T& value) {
+            size_t position = dequeue_position.load(std::memory_order_relaxed);
+            for(;;) {
+                Cell& cell = cells[position & mask];
+                size_t sequence = cell.sequence.load(std::memory_order_acquire);
+                intptr_t difference = (intptr_t)sequence - (intptr_t)(position + 1);
+                if(difference == 0) {
+                    if(dequeue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                        value = cell.data;
+                        cell.sequence.store(position + mask + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if(difference < 0) return false;
+                else position = dequeue_position.load(std::memory_order_relaxed);
+            }
+        }
+        // Wait until there is room (this is the backpressure of the pipeline)
+        void push(const T& value) {
+            int spins = 0;
+            while(!try_push(value)) backoff(spins);
+        }
+        // Wait until there is a value
+        T pop() {
+            T value;
+            int spins = 0;
+            while(!try_pop(value)) backoff(spins);
+            return value;
+        }
+};
+
+// Streaming decoder for a text stream of frames (63 whitespace separated symbols, * for erasures,
+// or 63 - s symbols of the shortened RS(63-s, 42-s) code) or a binary frame stream (rs_wire.h)
+// The pipeline has a reader thread, a pool of worker threads and an ordered writer:
+//  - the reader only cuts the input into chunks of whole frames by counting tokens,
+//  - the workers parse, decode and format their chunks independently,
+//  - the writer (the calling thread) prints the chunks in input order.
+// A fixed pool of chunks circulates between the stages, so at most 4 chunks per worker are in
+// flight and memory stays bounded however large the input is: the reader waits for the writer
+// to hand a chunk back when the workers or the output fall behind.
+// In text mode every frame gives one output line, the same as decoding it on its own: the 63
+// decoded symbols, "give up", or the error message for more than 21 erasures. In binary mode
+// every frame gives one record: the decoded frame with an empty erasure mask, or the received
+// frame (erased symbols set to 0) with its erasure mask and frame_failed_flag.
+class StreamDecoder {
+    private:
+        static const int n = RS63_42::n;
+        struct Chunk {
+            size_t sequence;
+            size_t frames;
+            size_t first_frame;  // Index of the first frame of the chunk in the input
+            size_t first_line;   // Line the chunk starts on (text mode)
+            std::string text;
+            std::string output;
+            std::string errors;  // Parse errors, printed to stderr in input order
+        };
+        KeyEquationSolver solver;
+        int threads;
+        size_t frames_per_chunk;
+        bool binary;
+        int frame_length;    // Symbols per text frame, 63 - s for a shortened code
+
+        // Append the decoded frame in the format of GF64_poly::print
+        static void format_frame(const uint8_t* codeword, int frame_length, std::string& output) {
+            char line[n * 3 + 1];
+            int length = 0;
+            for(int i = 0; i < frame_length; i++) {
+                int value = codeword[i];
+                if(value >= 10) line[length++] = '0' + value / 10;
+                line[length++] = '0' + value % 10;
+                line[length++] = ' ';
+            }
+            line[length++] = '\n';
+            output.append(line, length);
+        }
+
+        // Parse, decode and format every frame of a chunk, a malformed frame gives up
+        void decode_chunk(ReedSolomonDecoder& decoder, DecoderWorkspace& ws, Chunk& chunk) {
+            uint8_t symbols[n], codeword[n];
+            uint64_t erasure_mask;
+            const char* p = chunk.text.data();
+            const char* end = p + chunk.text.size();
+            size_t line = chunk.first_line;
+            TextParseError error;
+            chunk.output.clear();
+            chunk.errors.clear();
+            for(size_t f = 0; f < chunk.frames; f++) {
+                error.frame = chunk.first_frame + f;
+                p = parse_text_frame(p, end, symbols, erasure_mask, line, error, frame_length);
+                if(error.reason != nullptr) {
+                    char message[160];
+                    snprintf(message, sizeof(message), "Malformed input at line %zu (frame %zu, symbol %d): %s\n",
+                             error.line, error.frame, error.symbol, error.reason);
+                    chunk.errors += message;
+                    chunk.output += "give up\n";
+                    continue;
+                }
+                DecodeStatus status = frame_length == n ? decoder.decode_frame(symbols, erasure_mask, codeword, ws)
+                                                        : decoder.decode_shortened(symbols, frame_length, erasure_mask, codeword, ws);
+                if(status == DECODE_OK || status == DECODE_CORRECTED) format_frame(codeword, frame_length, chunk.output);
+                else if(status == DECODE_TOO_MANY_ERASURES) chunk.output += "Error: Erasure locator polynomial degree exceeds 21\n";
+                else chunk.output += "give up\n";
+            }
+        }
+
+        // Unpack, decode and pack every record of a binary chunk
+        void decode_binary_chunk(ReedSolomonDecoder& decoder, DecoderWorkspace& ws, Chunk& chunk) {
+            uint8_t symbols[64], codeword[64];
+            uint64_t erasure_mask;
+            chunk.output.resize(chunk.frames * frame_record_size);
+            for(size_t f = 0; f < chunk.frames; f++) {
+                unpack_frame((const uint8_t*)&chunk.text[f * frame_record_size], symbols, erasure_mask);
+                DecodeStatus status = decoder.decode_frame(symbols, erasure_mask, codeword, ws);
+                uint64_t output_mask = 0;
+                if(status != DECODE_OK && status != DECODE_CORRECTED) {
+                    output_mask = erasure_mask | frame_failed_flag;
+                }
+                pack_frame(codeword, output_mask, (uint8_t*)&chunk.output[f * frame_record_size]);
+            }
+        }
+
+        void worker(BoundedQueue<Chunk*>& work, BoundedQueue<Chunk*>& done) {
+            ReedSolomonDecoder decoder(solver);
+            DecoderWorkspace ws;
+            for(;;) {
+                Chunk* chunk = work.pop();
+                // A null chunk tells the worker that the input has ended
+                if(chunk == nullptr) return;
+                if(binary) decode_binary_chunk(decoder, ws, *chunk);
+                else decode_chunk(decoder, ws, *chunk);
+                done.push(chunk);
+            }
+        }
+
+        // Cut the input into chunks of frames_per_chunk frames, returns the number of chunks
+        // A frame split across two reads stays in the chunk that is being filled, and an incomplete
+        // frame at the end of the input is passed on so that the worker reports it
+        size_t reader(FILE* in, BoundedQueue<Chunk*>& free_chunks, BoundedQueue<Chunk*>& work) {
+            std::vector<char> block(1 << 20);
+            const size_t tokens_per_chunk = frames_per_chunk * frame_length;
+            size_t sequence = 0, tokens = 0, line = 1, frames = 0;
+            bool previous_space = true;
+            Chunk* chunk = free_chunks.pop();
+            chunk->text.clear();
+            chunk->first_line = line;
+            chunk->first_frame = frames;
+            size_t length;
+            while((length = fread(block.data(), 1, block.size(), in)) > 0) {
+                size_t run_start = 0;
+                for(size_t i = 0; i < length; i++) {
+                    bool space = text_char_class[(uint8_t)block[i]] == TEXT_SPACE;
+                    line += block[i] == '\n';
+                    if(!space && previous_space) {
+                        // The first token of the next chunk starts here
+                        if(tokens == tokens_per_chunk) {
+                            chunk->text.append(&block[run_start], i - run_start);
+                            chunk->sequence = sequence++;
+                            chunk->frames = frames_per_chunk;
+                            frames += frames_per_chunk;
+                            work.push(chunk);
+                            chunk = free_chunks.pop();
+                            chunk->text.clear();
+                            chunk->first_line = line;
+                            chunk->first_frame = frames;
+                            run_start = i;
+                            tokens = 0;
+                        }
+                        tokens++;
+                    }
+                    previous_space = space;
+                }
+                chunk->text.append(&block[run_start], length - run_start);
+            }
+            if(tokens > 0) {
+                chunk->sequence = sequence++;
+                chunk->frames = (tokens + frame_length - 1) / frame_length;
+                work.push(chunk);
+            }
+            else free_chunks.push(chunk);
+            return sequence;
+        }
+
+        // Cut a binary stream (after its header, which run() has checked) into chunks of frames_per_chunk records
+        size_t binary_reader(FILE* in, BoundedQueue<Chunk*>& free_chunks, BoundedQueue<Chunk*>& work) {
+            size_t sequence = 0;
+            for(;;) {
+                Chunk* chunk = free_chunks.pop();
+                chunk->text.resize(frames_per_chunk * frame_record_size);
+                size_t length = fread(&chunk->text[0], 1, chunk->text.size(), in);
+                if(length % frame_record_size != 0) {
+                    fprintf(stderr, "Warning: ignoring an incomplete record of %zu bytes at the end of the input\n",
+                            length % frame_record_size);
+                }
+                chunk->frames = length / frame_record_size;
+                chunk->errors.clear();
+                if(chunk->frames == 0) {
+                    free_chunks.push(chunk);
+                    return sequence;
+                }
+                chunk->sequence = sequence++;
+                work.push(chunk);
+                if(length < chunk->text.size()) return sequence;
+            }
+        }
+
+    public:
+        StreamDecoder(KeyEquationSolver solver = RS_KEY_EQUATION_SOLVER, int threads = 1,
+                      size_t frames_per_chunk = 512, bool binary = false, int frame_length = n) {
+            this->solver = solver;
+            this->threads = threads < 1 ? 1 : threads;
+            this->frames_per_chunk = frames_per_chunk < 1 ? 1 : frames_per_chunk;
+            this->binary = binary;
+            this->frame_length = frame_length;
+        }
+
+        // Decode every frame of in and write the results to out in input order, frames is set to
+        // the number of frames decoded
+        // Returns false, without writing anything to out, if a binary input has no valid header
+        bool run(FILE* in, FILE* out, size_t& frames) {
+            frames = 0;
+            if(binary) {
+                uint8_t header[frame_header_size];
+                if(fread(header, 1, frame_header_size, in) != frame_header_size || !check_frame_header(header)) {
+                    fprintf(stderr, "Error: the input is not a RS(63,42) frame stream\n");
+                    return false;
+                }
+                make_frame_header(header);
+                fwrite(header, 1, frame_header_size, out);
+            }
+            const size_t pool_size = 4 * threads;
+            std::vector<Chunk> pool(pool_size);
+            // The queues can hold the whole pool (plus the end markers), so only the free list blocks
+            BoundedQueue<Chunk*> free_chunks(pool_size), work(pool_size + threads), done(pool_size);
+            for(auto& chunk : pool) free_chunks.push(&chunk);
+
+            std::atomic<size_t> total_chunks(SIZE_MAX);
+            std::thread reading([&]() {
+                size_t chunks = binary ? binary_reader(in, free_chunks, work) : reader(in, free_chunks, work);
+                total_chunks.store(chunks, std::memory_order_release);
+                for(int t = 0; t < threads; t++) work.push(nullptr);
+            });
+            std::vector<std::thread> workers;
+            for(int t = 0; t < threads; t++) {
+                workers.emplace_back(&StreamDecoder::worker, this, std::ref(work), std::ref(done));
+            }
+
+            // Chunks that finish early wait in their slot (sequence mod pool size) until it is their turn
+            std::vector<Chunk*> pending(pool_size, nullptr);
+            size_t next = 0;
+            int spins = 0;
+            while(next < total_chunks.load(std::memory_order_acquire)) {
+                Chunk* chunk;
+                if(!done.try_pop(chunk)) {
+                    if(++spins >= 64) std::this_thread::yield();
+                    continue;
+                }
+                spins = 0;
+                pending[chunk->sequence % pool_size] = chunk;
+                while(pending[next % pool_size] != nullptr && pending[next % pool_size]->sequence == next) {
+                    Chunk* ready = pending[next % pool_size];
+                    pending[next % pool_size] = nullptr;
+                    fwrite(ready->output.data(), 1, ready->output.size(), out);
+                    if(!ready->errors.empty()) fputs(ready->errors.c_str(), stderr);
+                    frames += ready->frames;
+                    free_chunks.push(ready);
+                    next++;
+                }
+            }
+            reading.join();
+            for(auto& thread : workers) thread.join();
+            fflush(out);
+            return true;
+        }
+};
+
+#endif
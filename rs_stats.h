@@ -0,0 +1,234 @@
+#ifndef RS_STATS_H
+#define RS_STATS_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <vector>
+
+// Decoder latency instrumentation
+// Compile with -DRS_DECODER_STATS to count cycles per decoder stage. Without it the macros below
+// expand to nothing (RS_STATS_RESULT to its status), so the decoder compiles exactly as before.
+// Every thread accumulates into its own thread-local DecoderStats; only the owning thread writes
+// it (plain relaxed loads and stores, no locked instructions), and decoder_stats_snapshot()
+// merges the counters of all threads, including the ones that have exited, at any time.
+
+enum DecodeStage : uint8_t {
+    STAGE_SYNDROMES = 0,
+    STAGE_ERASURE_LOCATOR,
+    STAGE_KEY_EQUATION,
+    STAGE_CHIEN_FORNEY,
+    STAGE_TOTAL,        // The whole decode_frame call
+    STAGE_COUNT
+};
+
+inline const char* decode_stage_name(int stage) {
+    static const char* names[STAGE_COUNT] = {"syndromes", "erasure locator", "key equation", "chien/forney", "total"};
+    return names[stage];
+}
+
+// Latency histogram with 4 buckets per power of two of cycles (bucket width <= 25%)
+const int stats_buckets = 4 * 64;
+
+inline int stats_bucket(uint64_t cycles) {
+    if(cycles < 4) return (int)cycles;
+    int exponent = 63 - __builtin_clzll(cycles);
+    return 4 * (exponent - 1) + (int)((cycles >> (exponent - 2)) & 3);
+}
+// Smallest cycle count of a bucket
+inline uint64_t stats_bucket_floor(int bucket) {
+    if(bucket < 4) return bucket;
+    int exponent = bucket / 4 + 1;
+    return (4ULL + (bucket & 3)) << (exponent - 2);
+}
+
+// Plain (non-atomic) copy of the counters, the result of a snapshot
+struct DecoderStatsSnapshot {
+    uint64_t frames = 0;
+    uint64_t zero_syndrome = 0;      // Frames that left after the syndromes (nothing to correct)
+    uint64_t corrected = 0;
+    uint64_t too_many_erasures = 0;  // Give-ups before the key equation
+    uint64_t uncorrectable = 0;      // Give-ups after the Chien search
+    uint64_t malformed = 0;          // Rejected before the syndromes
+    uint64_t calls[STAGE_COUNT] = {0};
+    uint64_t cycles[STAGE_COUNT] = {0};
+    uint64_t histogram[STAGE_COUNT][stats_buckets] = {{0}};
+
+    // Approximate percentile (0~100) of the cycles of one stage, the floor of its bucket
+    uint64_t percentile(int stage, double percent) const {
+        uint64_t rank = (uint64_t)(calls[stage] * percent / 100.0), seen = 0;
+        for(int b = 0; b < stats_buckets; b++) {
+            seen += histogram[stage][b];
+            if(seen > rank) return stats_bucket_floor(b);
+        }
+        return 0;
+    }
+    // Counters accumulated since an earlier snapshot (for periodic dumps)
+    DecoderStatsSnapshot operator-(const DecoderStatsSnapshot& earlier) const {
+        DecoderStatsSnapshot delta = *this;
+        delta.frames -= earlier.frames;
+        delta.zero_syndrome -= earlier.zero_syndrome;
+        delta.corrected -= earlier.corrected;
+        delta.too_many_erasures -= earlier.too_many_erasures;
+        delta.uncorrectable -= earlier.uncorrectable;
+        delta.malformed -= earlier.malformed;
+        for(int s = 0; s < STAGE_COUNT; s++) {
+            delta.calls[s] -= earlier.calls[s];
+            delta.cycles[s] -= earlier.cycles[s];
+            for(int b = 0; b < stats_buckets; b++) delta.histogram[s][b] -= earlier.histogram[s][b];
+        }
+        return delta;
+    }
+    void print(FILE* out) const {
+        fprintf(out, "frames %llu: zero syndrome %llu, corrected %llu, too many erasures %llu, uncorrectable %llu, "
+                "malformed %llu\n", (unsigned long long)frames, (unsigned long long)zero_syndrome,
+                (unsigned long long)corrected, (unsigned long long)too_many_erasures, (unsigned long long)uncorrectable,
+                (unsigned long long)malformed);
+        fprintf(out, "%-16s %12s %12s %10s %10s %10s %10s\n", "stage (cycles)", "calls", "mean", "p50", "p99", "p99.9", "max");
+        for(int s = 0; s < STAGE_COUNT; s++) {
+            if(calls[s] == 0) continue;
+            uint64_t max = 0;
+            for(int b = 0; b < stats_buckets; b++) if(histogram[s][b] != 0) max = stats_bucket_floor(b);
+            fprintf(out, "%-16s %12llu %12.0f %10llu %10llu %10llu %10llu\n", decode_stage_name(s),
+                    (unsigned long long)calls[s], (double)cycles[s] / calls[s], (unsigned long long)percentile(s, 50),
+                    (unsigned long long)percentile(s, 99), (unsigned long long)percentile(s, 99.9),
+                    (unsigned long long)max);
+        }
+    }
+};
+
+#ifdef RS_DECODER_STATS
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+inline uint64_t decoder_stats_clock() { return __rdtsc(); }
+#else
+#include <chrono>
+inline uint64_t decoder_stats_clock() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+#endif
+
+// Counters of one thread
+struct DecoderStats {
+    std::atomic<uint64_t> frames{0}, zero_syndrome{0}, corrected{0}, too_many_erasures{0}, uncorrectable{0},
+                          malformed{0};
+    std::atomic<uint64_t> calls[STAGE_COUNT], cycles[STAGE_COUNT];
+    std::atomic<uint64_t> histogram[STAGE_COUNT][stats_buckets];
+
+    DecoderStats() {
+        for(int s = 0; s < STAGE_COUNT; s++) {
+            calls[s].store(0, std::memory_order_relaxed);
+            cycles[s].store(0, std::memory_order_relaxed);
+            for(int b = 0; b < stats_buckets; b++) histogram[s][b].store(0, std::memory_order_relaxed);
+        }
+    }
+    // Only the owning thread writes, so a load and a store are enough
+    static void add(std::atomic<uint64_t>& counter, uint64_t value) {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+    void record_stage(int stage, uint64_t elapsed) {
+        add(calls[stage], 1);
+        add(cycles[stage], elapsed);
+        add(histogram[stage][stats_bucket(elapsed)], 1);
+    }
+    void add_to(DecoderStatsSnapshot& total) const {
+        total.frames += frames.load(std::memory_order_relaxed);
+        total.zero_syndrome += zero_syndrome.load(std::memory_order_relaxed);
+        total.corrected += corrected.load(std::memory_order_relaxed);
+        total.too_many_erasures += too_many_erasures.load(std::memory_order_relaxed);
+        total.uncorrectable += uncorrectable.load(std::memory_order_relaxed);
+        total.malformed += malformed.load(std::memory_order_relaxed);
+        for(int s = 0; s < STAGE_COUNT; s++) {
+            total.calls[s] += calls[s].load(std::memory_order_relaxed);
+            total.cycles[s] += cycles[s].load(std::memory_order_relaxed);
+            for(int b = 0; b < stats_buckets; b++) total.histogram[s][b] += histogram[s][b].load(std::memory_order_relaxed);
+        }
+    }
+};
+
+// Registry of the live thread-local counters, and the merged counters of exited threads
+struct DecoderStatsRegistry {
+    std::mutex mutex;
+    std::vector<const DecoderStats*> threads;
+    DecoderStatsSnapshot retired;
+};
+inline DecoderStatsRegistry& decoder_stats_registry() {
+    static DecoderStatsRegistry registry;
+    return registry;
+}
+
+// Thread-local counters, registered on first use and merged into the retired total on thread exit
+struct ThreadDecoderStats {
+    DecoderStats stats;
+    ThreadDecoderStats() {
+        DecoderStatsRegistry& registry = decoder_stats_registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.threads.push_back(&stats);
+    }
+    ~ThreadDecoderStats() {
+        DecoderStatsRegistry& registry = decoder_stats_registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        stats.add_to(registry.retired);
+        for(size_t i = 0; i < registry.threads.size(); i++) {
+            if(registry.threads[i] == &stats) {
+                registry.threads.erase(registry.threads.begin() + i);
+                break;
+            }
+        }
+    }
+};
+inline DecoderStats& thread_decoder_stats() {
+    static thread_local ThreadDecoderStats local;
+    return local.stats;
+}
+
+// Close the current stage: record the cycles since clock and return the new clock
+inline uint64_t decoder_stats_stage(int stage, uint64_t clock) {
+    uint64_t now = decoder_stats_clock();
+    thread_decoder_stats().record_stage(stage, now - clock);
+    return now;
+}
+// Count the outcome of a frame and its total latency, returns the status
+template<typename Status>
+inline Status decoder_stats_result(Status status, uint64_t start) {
+    int outcome = (int)status;
+    DecoderStats& stats = thread_decoder_stats();
+    stats.record_stage(STAGE_TOTAL, decoder_stats_clock() - start);
+    DecoderStats::add(stats.frames, 1);
+    std::atomic<uint64_t>* outcomes[5] = {&stats.zero_syndrome, &stats.corrected, &stats.too_many_erasures,
+                                          &stats.uncorrectable, &stats.malformed};
+    DecoderStats::add(*outcomes[outcome], 1);
+    return status;
+}
+
+// Merge the counters of every thread
+inline DecoderStatsSnapshot decoder_stats_snapshot() {
+    DecoderStatsRegistry& registry = decoder_stats_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    DecoderStatsSnapshot total = registry.retired;
+    for(const DecoderStats* stats : registry.threads) stats->add_to(total);
+    return total;
+}
+inline bool decoder_stats_enabled() { return true; }
+
+// start and clock name local variables of the instrumented functions
+#define RS_STATS_START(start, clock) uint64_t start = decoder_stats_clock(), clock = start
+#define RS_STATS_CLOCK(clock) uint64_t clock = decoder_stats_clock()
+#define RS_STATS_STAGE(clock, stage) clock = decoder_stats_stage(stage, clock)
+#define RS_STATS_RESULT(status, start) decoder_stats_result(status, start)
+
+#else
+
+inline DecoderStatsSnapshot decoder_stats_snapshot() { return DecoderStatsSnapshot(); }
+inline bool decoder_stats_enabled() { return false; }
+
+#define RS_STATS_START(start, clock)
+#define RS_STATS_CLOCK(clock)
+#define RS_STATS_STAGE(clock, stage)
+#define RS_STATS_RESULT(status, start) (status)
+
+#endif
+
+#endif
@@ -0,0 +1,160 @@
+#ifndef RS_TEXT_H
+#define RS_TEXT_H
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <unistd.h>
+
+// Text frame parser shared by the tools
+// A frame is 63 whitespace separated tokens, each a symbol 0~63 or * for an erasure.
+// The parser works on whole blocks of text: characters are classified with one table lookup,
+// a symbol has at most 2 digits so the digit loop is bounded, and lines are counted without
+// branches while skipping whitespace. Malformed frames are still consumed token by token, so
+// one bad token does not shift the following frames, and the first problem of every frame is
+// reported with its line, frame and symbol index.
+
+enum TextCharClass : uint8_t { TEXT_OTHER = 0, TEXT_SPACE = 1, TEXT_DIGIT = 2, TEXT_STAR = 3 };
+
+constexpr std::array<uint8_t, 256> make_text_char_class() {
+    std::array<uint8_t, 256> table{};
+    for(int c : {' ', '\n', '\t', '\r', '\v', '\f'}) table[c] = TEXT_SPACE;
+    for(int c = '0'; c <= '9'; c++) table[c] = TEXT_DIGIT;
+    table['*'] = TEXT_STAR;
+    return table;
+}
+inline constexpr std::array<uint8_t, 256> text_char_class = make_text_char_class();
+
+// First problem found in a frame (reason is nullptr if the frame is well formed)
+struct TextParseError {
+    size_t line;        // 1-based line of the offending token
+    size_t frame;       // 0-based frame index in the input
+    int symbol;         // 0-based symbol index in the frame
+    const char* reason;
+};
+
+// Print a parse error as "Malformed input at line L (frame F, symbol S): reason"
+inline void report_text_error(FILE* out, const TextParseError& error) {
+    fprintf(out, "Malformed input at line %zu (frame %zu, symbol %d): %s\n",
+            error.line, error.frame, error.symbol, error.reason);
+}
+
+// Parse one frame from [p, end) into length symbols (63, fewer for a shortened code) and the erasure
+// mask, returns the position after it
+// line is advanced over the newlines consumed; error.reason stays nullptr if the frame is well formed
+inline const char* parse_text_frame(const char* p, const char* end, uint8_t* symbols, uint64_t& erasure_mask,
+                                    size_t& line, TextParseError& error, int length = 63) {
+    error.reason = nullptr;
+    erasure_mask = 0;
+    size_t first_line = line;
+    for(int i = 0; i < length; i++) {
+        while(p < end && text_char_class[(uint8_t)*p] == TEXT_SPACE) line += (*p++ == '\n');
+        if(i == 0) first_line = line;
+        if(p == end) {
+            // Reported on the line the frame starts
+            for(int j = i; j < length; j++) symbols[j] = 0;
+            if(error.reason == nullptr) error = {first_line, error.frame, i, "incomplete frame at the end of the input"};
+            return p;
+        }
+        uint8_t type = text_char_class[(uint8_t)*p];
+        int value = 0;
+        if(type == TEXT_STAR) {
+            erasure_mask |= 1ULL << i;
+            p++;
+        }
+        else if(type == TEXT_DIGIT) {
+            // At most 2 digits fit a symbol, more only tell that the value is too large
+            value = *p++ - '0';
+            if(p < end && text_char_class[(uint8_t)*p] == TEXT_DIGIT) value = value * 10 + (*p++ - '0');
+            if(p < end && text_char_class[(uint8_t)*p] == TEXT_DIGIT) {
+                value = 64;
+                while(p < end && text_char_class[(uint8_t)*p] == TEXT_DIGIT) p++;
+            }
+        }
+        // The token must end here
+        bool clean = type != TEXT_OTHER && (p == end || text_char_class[(uint8_t)*p] == TEXT_SPACE);
+        while(p < end && text_char_class[(uint8_t)*p] != TEXT_SPACE) p++;
+        if(error.reason == nullptr && (!clean || value > 63)) {
+            error = {line, error.frame, i, !clean ? (type == TEXT_OTHER ? "unexpected character" : "invalid token")
+                                                  : "symbol out of range 0~63"};
+        }
+        symbols[i] = value & 63;
+    }
+    return p;
+}
+
+// Buffered reader of text frames
+// It reads large blocks with read(2), which returns what is available, so it also works with
+// prompts on a terminal, and parses all the complete frames of a block in one call. A frame that
+// runs into the end of the block is parsed again once more input has arrived.
+class TextFrameReader {
+    private:
+        int fd;
+        std::vector<char> buffer;
+        size_t begin, end;
+        bool eof;
+        size_t line, frame;
+        int frame_length;
+
+        // Read more input after the unparsed bytes, growing the buffer if it is full
+        void refill() {
+            if(begin > 0) {
+                memmove(buffer.data(), buffer.data() + begin, end - begin);
+                end -= begin;
+                begin = 0;
+            }
+            if(end == buffer.size()) buffer.resize(buffer.size() * 2);
+            ssize_t length = ::read(fd, buffer.data() + end, buffer.size() - end);
+            if(length <= 0) eof = true;
+            else end += length;
+        }
+
+    public:
+        // frame_length is the number of symbols per frame (63 - s for a shortened code)
+        TextFrameReader(FILE* in, size_t block_size = 1 << 20, int frame_length = 63)
+            : fd(fileno(in)), buffer(block_size), begin(0), end(0), eof(false), line(1), frame(0),
+              frame_length(frame_length) {}
+
+        // Read up to max_frames frames into symbols (stride bytes per frame) and erasure_masks, with the
+        // parse result of every frame in errors; returns the number of frames read, 0 at the end of the input
+        // An incomplete frame at the end of the input is returned with an error
+        size_t read(uint8_t* symbols, uint64_t* erasure_masks, TextParseError* errors, size_t max_frames,
+                    size_t stride = 64) {
+            size_t frames = 0;
+            while(frames < max_frames) {
+                const char* start = buffer.data() + begin;
+                const char* stop = buffer.data() + end;
+                // Skip the whitespace between frames, stop at the end of the input
+                const char* p = start;
+                while(p < stop && text_char_class[(uint8_t)*p] == TEXT_SPACE) p++;
+                if(p == stop) {
+                    if(eof || frames > 0) break;
+                    refill();
+                    continue;
+                }
+                size_t frame_line = line;
+                errors[frames].frame = frame;
+                p = parse_text_frame(start, stop, symbols + frames * stride, erasure_masks[frames], line, errors[frames],
+                                     frame_length);
+                // A frame that runs into the end of the buffer may go on in the next read
+                if(p == stop && !eof) {
+                    line = frame_line;
+                    if(frames > 0) break;
+                    refill();
+                    continue;
+                }
+                begin = p - buffer.data();
+                frame++;
+                frames++;
+            }
+            return frames;
+        }
+        // Read one frame, returns false at the end of the input
+        bool read(uint8_t* symbols, uint64_t& erasure_mask, TextParseError& error) {
+            return read(symbols, &erasure_mask, &error, 1) == 1;
+        }
+};
+
+#endif
@@ -0,0 +1,137 @@
+#ifndef RS_WIRE_H
+#define RS_WIRE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+// Packed binary codeword stream shared by every tool
+// A stream is an 8-byte header followed by 56-byte frame records:
+//  - header: "RS63", version, n = 63, k = 42, flags (0)
+//  - record: 48 bytes of symbols, symbol i in bits 6i ~ 6i+5 of the little-endian bit stream
+//    (bits 378 ~ 383 are 0), then the 8-byte little-endian erasure mask (bit i marks symbol i)
+// Bit 63 of the mask is not a symbol; the decoder sets it on frames it gave up on.
+// The packing copies 64-bit words to and from the record, so it only builds on a little-endian host.
+
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "rs_wire.h packs records as little-endian 64-bit words");
+
+const int frame_header_size = 8;
+const int frame_symbol_bytes = 48;
+const int frame_record_size = 56;
+const uint8_t frame_format_version = 1;
+// Set in the erasure mask of a frame that could not be decoded
+const uint64_t frame_failed_flag = 1ULL << 63;
+
+// Pack 63 symbols (values 0~63, one per byte) and the erasure mask into one record
+// Every 8 symbols (8 bytes of 6 bits) are squeezed into 6 bytes: 6-bit fields are merged into
+// 12-bit fields, then 24-bit fields, then one 48-bit field
+inline void pack_frame(const uint8_t* symbols, uint64_t erasure_mask, uint8_t* record) {
+    for(int group = 0; group < 8; group++) {
+        uint64_t x = 0;
+        memcpy(&x, symbols + 8 * group, group < 7 ? 8 : 7);
+        x &= 0x3F3F3F3F3F3F3F3FULL;
+        x = (x & 0x003F003F003F003FULL) | ((x & 0x3F003F003F003F00ULL) >> 2);
+        x = (x & 0x00000FFF00000FFFULL) | ((x & 0x0FFF00000FFF0000ULL) >> 4);
+        x = (x & 0x0000000000FFFFFFULL) | ((x & 0x00FFFFFF00000000ULL) >> 8);
+        memcpy(record + 6 * group, &x, 6);
+    }
+    memcpy(record + frame_symbol_bytes, &erasure_mask, 8);
+}
+
+// Unpack a record into 63 symbols (one per byte) and the erasure mask
+inline void unpack_frame(const uint8_t* record, uint8_t* symbols, uint64_t& erasure_mask) {
+    for(int group = 0; group < 8; group++) {
+        uint64_t x = 0;
+        memcpy(&x, record + 6 * group, 6);
+        x = (x & 0x0000000000FFFFFFULL) | ((x & 0x0000FFFFFF000000ULL) << 8);
+        x = (x & 0x00000FFF00000FFFULL) | ((x & 0x00FFF00000FFF000ULL) << 4);
+        x = (x & 0x003F003F003F003FULL) | ((x & 0x0FC00FC00FC00FC0ULL) << 2);
+        memcpy(symbols + 8 * group, &x, group < 7 ? 8 : 7);
+    }
+    memcpy(&erasure_mask, record + frame_symbol_bytes, 8);
+}
+
+// Fill the 8-byte stream header
+inline void make_frame_header(uint8_t* header) {
+    const uint8_t values[frame_header_size] = {'R', 'S', '6', '3', frame_format_version, 63, 42, 0};
+    memcpy(header, values, frame_header_size);
+}
+
+// Check a stream header (magic, version and code parameters)
+inline bool check_frame_header(const uint8_t* header) {
+    uint8_t expected[frame_header_size];
+    make_frame_header(expected);
+    return memcmp(header, expected, frame_header_size) == 0;
+}
+
+// Buffered reader of a binary frame stream
+class FrameReader {
+    private:
+        FILE* in;
+        std::vector<uint8_t> buffer;
+    public:
+        FrameReader(FILE* in, size_t buffered_frames = 4096) : in(in), buffer(buffered_frames * frame_record_size) {}
+        // Read and check the header, returns false if the stream is not a frame stream
+        bool read_header() {
+            uint8_t header[frame_header_size];
+            return fread(header, 1, frame_header_size, in) == frame_header_size && check_frame_header(header);
+        }
+        // Read up to max_frames frames into symbols (stride bytes per frame) and erasure_masks
+        // Returns the number of frames read, 0 at the end of the stream
+        size_t read(uint8_t* symbols, uint64_t* erasure_masks, size_t max_frames, size_t stride = 64) {
+            size_t frames = 0;
+            while(frames < max_frames) {
+                size_t wanted = std::min(max_frames - frames, buffer.size() / frame_record_size);
+                size_t got = fread(buffer.data(), frame_record_size, wanted, in);
+                for(size_t f = 0; f < got; f++) {
+                    unpack_frame(&buffer[f * frame_record_size], symbols + (frames + f) * stride, erasure_masks[frames + f]);
+                }
+                frames += got;
+                if(got < wanted) break;
+            }
+            return frames;
+        }
+        // Read one frame, returns false at the end of the stream
+        bool read(uint8_t* symbols, uint64_t& erasure_mask) {
+            return read(symbols, &erasure_mask, 1) == 1;
+        }
+};
+
+// Buffered writer of a binary frame stream
+class FrameWriter {
+    private:
+        FILE* out;
+        std::vector<uint8_t> buffer;
+        size_t buffered;
+    public:
+        FrameWriter(FILE* out, size_t buffered_frames = 4096)
+            : out(out), buffer(buffered_frames * frame_record_size), buffered(0) {}
+        ~FrameWriter() { flush(); }
+        FrameWriter(const FrameWriter&) = delete;
+        FrameWriter& operator=(const FrameWriter&) = delete;
+        void write_header() {
+            uint8_t header[frame_header_size];
+            make_frame_header(header);
+            fwrite(header, 1, frame_header_size, out);
+        }
+        // Write count frames from symbols (stride bytes per frame) and erasure_masks
+        void write(const uint8_t* symbols, const uint64_t* erasure_masks, size_t count, size_t stride = 64) {
+            for(size_t f = 0; f < count; f++) {
+                if(buffered == buffer.size()) flush();
+                pack_frame(symbols + f * stride, erasure_masks[f], &buffer[buffered]);
+                buffered += frame_record_size;
+            }
+        }
+        void write(const uint8_t* symbols, uint64_t erasure_mask) {
+            write(symbols, &erasure_mask, 1);
+        }
+        void flush() {
+            if(buffered > 0) fwrite(buffer.data(), 1, buffered, out);
+            buffered = 0;
+            fflush(out);
+        }
+};
+
+#endif
@@ -0,0 +1,178 @@
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+#include <chrono>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "rs_decoder.h"
+#include "rs_encoder.h"
+#include "rs_stats.h"
+
+// Monte Carlo frame error rate simulator
+// For every (errors, erasures) cell of the grid, random messages are encoded, corrupted with
+// exactly that many errors (random nonzero values) and erasures at distinct random positions,
+// and decoded on all cores. Every frame ends in one of three outcomes:
+//  - success: the decoder returns the transmitted codeword
+//  - miscorrection: the decoder returns a different codeword without noticing
+//  - give up: the decoder reports the frame as uncorrectable (or too many erasures)
+// Build: g++ -std=c++17 -O2 -march=native -pthread simulator.cpp -o simulator
+// Usage: simulator [--errors A:B[:STEP]] [--erasures A:B[:STEP]] [--frames N] [--threads T]
+//                  [--solver euclid|bm] [--seed S] [--csv] [--stats]
+// --stats prints the per-stage decode latency of every cell to stderr (build with -DRS_DECODER_STATS)
+
+struct CellResult {
+    long frames = 0;
+    long success = 0;
+    long miscorrected = 0;
+    long gave_up = 0;
+};
+
+// Uniform integer in [0, range) from one 64-bit random number (multiply-shift, no division)
+inline int random_below(std::mt19937_64& gen, int range) {
+    return (int)(((gen() >> 32) * (uint64_t)range) >> 32);
+}
+
+// Simulate frames of one cell on one thread, in batches that reuse the same buffers
+CellResult simulate(const BatchEncoder& encoder, KeyEquationSolver solver, int num_errors, int num_erasures,
+                    long frames, uint64_t seed) {
+    const size_t batch_size = 4096;
+    std::mt19937_64 gen(seed);
+    ReedSolomonDecoder decoder(solver);
+    CodewordBatch batch(batch_size);
+    std::vector<uint8_t> messages(batch_size * 42), sent(batch_size * CodewordBatch::stride);
+    CellResult result;
+    int positions[63];
+    while(result.frames < frames) {
+        size_t count = std::min<long>(batch_size, frames - result.frames);
+        for(auto& symbol : messages) symbol = gen() & 63;
+        encoder.encode_batch(messages.data(), count, sent.data());
+        for(size_t f = 0; f < count; f++) {
+            uint8_t* frame = batch.frame(f);
+            memcpy(frame, &sent[f * CodewordBatch::stride], 63);
+            // Partial Fisher-Yates shuffle: the first errors + erasures positions are distinct
+            for(int i = 0; i < 63; i++) positions[i] = i;
+            uint64_t erasure_mask = 0;
+            for(int i = 0; i < num_errors + num_erasures; i++) {
+                int j = i + random_below(gen, 63 - i);
+                std::swap(positions[i], positions[j]);
+                if(i < num_erasures) {
+                    erasure_mask |= 1ULL << positions[i];
+                    frame[positions[i]] = 0;
+                }
+                else frame[positions[i]] ^= 1 + random_below(gen, 63);
+            }
+            batch.erasure_masks[f] = erasure_mask;
+        }
+        decoder.decode_batch(batch.symbols, batch.erasure_masks, count, batch.corrected, batch.status);
+        for(size_t f = 0; f < count; f++) {
+            if(batch.status[f] == DECODE_OK || batch.status[f] == DECODE_CORRECTED) {
+                if(memcmp(batch.corrected_frame(f), &sent[f * CodewordBatch::stride], 63) == 0) result.success++;
+                else result.miscorrected++;
+            }
+            else result.gave_up++;
+        }
+        result.frames += count;
+    }
+    return result;
+}
+
+// Parse A:B[:STEP] into a list of values
+bool parse_range(const char* text, std::vector<int>& values) {
+    int first, last, step = 1;
+    int fields = sscanf(text, "%d:%d:%d", &first, &last, &step);
+    if(fields == 1) last = first;
+    if(fields < 1 || step < 1 || first < 0 || last < first) return false;
+    values.clear();
+    for(int value = first; value <= last; value += step) values.push_back(value);
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<int> errors, erasures;
+    parse_range("0:10", errors);
+    parse_range("0:20:4", erasures);
+    long frames = 1000000;
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+    KeyEquationSolver solver = RS_KEY_EQUATION_SOLVER;
+    uint64_t seed = 2025;
+    bool csv = false, stats = false;
+    for(int i = 1; i < argc; i++) {
+        bool has_value = i + 1 < argc;
+        if(strcmp(argv[i], "--errors") == 0 && has_value && parse_range(argv[i + 1], errors)) i++;
+        else if(strcmp(argv[i], "--erasures") == 0 && has_value && parse_range(argv[i + 1], erasures)) i++;
+        else if(strcmp(argv[i], "--frames") == 0 && has_value) frames = atol(argv[++i]);
+        else if(strcmp(argv[i], "--threads") == 0 && has_value) threads = std::max(1, atoi(argv[++i]));
+        else if(strcmp(argv[i], "--seed") == 0 && has_value) seed = strtoull(argv[++i], nullptr, 10);
+        else if(strcmp(argv[i], "--csv") == 0) csv = true;
+        else if(strcmp(argv[i], "--stats") == 0) stats = true;
+        else if(strcmp(argv[i], "--solver") == 0 && has_value && strcmp(argv[i + 1], "bm") == 0) {
+            solver = KEY_EQUATION_BERLEKAMP_MASSEY;
+            i++;
+        }
+        else if(strcmp(argv[i], "--solver") == 0 && has_value && strcmp(argv[i + 1], "euclid") == 0) {
+            solver = KEY_EQUATION_EUCLIDEAN;
+            i++;
+        }
+        else {
+            fprintf(stderr, "Usage: %s [--errors A:B[:STEP]] [--erasures A:B[:STEP]] [--frames N] [--threads T]\n"
+                            "       [--solver euclid|bm] [--seed S] [--csv] [--stats]\n", argv[0]);
+            return 1;
+        }
+    }
+    if(stats && !decoder_stats_enabled()) {
+        fprintf(stderr, "Decoder statistics are not compiled in (build with -DRS_DECODER_STATS)\n");
+        stats = false;
+    }
+    // The encoder tables are shared read-only by every thread
+    const BatchEncoder& encoder = BatchEncoder::instance();
+
+    if(csv) printf("errors,erasures,frames,success,miscorrected,gave_up,frames_per_second\n");
+    else {
+        printf("%ld frames per cell, %d thread%s\n", frames, threads, threads > 1 ? "s" : "");
+        printf("%7s %9s %10s %12s %12s %14s\n", "errors", "erasures", "success", "miscorrect", "give up", "frames/s");
+    }
+    for(int num_errors : errors) {
+        for(int num_erasures : erasures) {
+            if(num_errors + num_erasures > 63) continue;
+            DecoderStatsSnapshot stats_before = decoder_stats_snapshot();
+            std::vector<CellResult> results(threads);
+            std::vector<std::thread> workers;
+            auto start = std::chrono::steady_clock::now();
+            for(int t = 0; t < threads; t++) {
+                long share = frames / threads + (t < frames % threads ? 1 : 0);
+                // Every cell and thread gets its own random stream
+                uint64_t stream = seed ^ ((uint64_t)num_errors << 48) ^ ((uint64_t)num_erasures << 40) ^ ((uint64_t)t << 32);
+                workers.emplace_back([&, t, share, stream, num_errors, num_erasures]() {
+                    results[t] = simulate(encoder, solver, num_errors, num_erasures, share, stream);
+                });
+            }
+            for(auto& worker : workers) worker.join();
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            CellResult total;
+            for(const auto& result : results) {
+                total.frames += result.frames;
+                total.success += result.success;
+                total.miscorrected += result.miscorrected;
+                total.gave_up += result.gave_up;
+            }
+            double rate = total.frames / seconds;
+            if(csv) {
+                printf("%d,%d,%ld,%ld,%ld,%ld,%.0f\n", num_errors, num_erasures, total.frames, total.success,
+                       total.miscorrected, total.gave_up, rate);
+            }
+            else {
+                double scale = 100.0 / std::max(1L, total.frames);
+                printf("%7d %9d %9.4f%% %11.4f%% %11.4f%% %14.0f\n", num_errors, num_erasures,
+                       total.success * scale, total.miscorrected * scale, total.gave_up * scale, rate);
+            }
+            fflush(stdout);
+            if(stats) {
+                fprintf(stderr, "errors %d, erasures %d: ", num_errors, num_erasures);
+                (decoder_stats_snapshot() - stats_before).print(stderr);
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,48 @@
+// BitslicedDecoder gives every frame the status and output of ReedSolomonDecoder::decode_batch,
+// with groups below and above the bit-sliced lane threshold and a partial last group
+#include <memory>
+#include "rs_bitsliced.h"
+#include "test_common.h"
+
+// Fill a batch: each frame is corrupt with the given probability, with up to max_errors
+// errors and max_erasures erasures; a few frames are malformed or have too many erasures
+static void fill(std::mt19937& gen, CodewordBatch& batch, double corrupt_rate, int max_errors, int max_erasures) {
+    std::uniform_real_distribution<double> uniform(0, 1);
+    for(size_t f = 0; f < batch.count; f++) {
+        uint8_t codeword[64];
+        random_codeword(gen, codeword);
+        int errors = 0, erasures = 0;
+        if(uniform(gen) < corrupt_rate) {
+            errors = gen() % (max_errors + 1);
+            erasures = gen() % (max_erasures + 1);
+        }
+        batch.erasure_masks[f] = corrupt(gen, codeword, errors, erasures, batch.frame(f));
+        if(f % 97 == 5) batch.frame(f)[gen() % 63] |= 0x80;
+    }
+}
+
+int main() {
+    std::mt19937 gen(9);
+    struct Mix { double rate; int errors, erasures; } mixes[] = {
+        {0, 0, 0}, {0.01, 1, 0}, {0.05, 10, 0}, {0.1, 3, 3}, {0.2, 2, 0}, {1, 1, 0}, {1, 4, 4}, {1, 10, 0},
+        {1, 0, 21}, {1, 14, 0}, {1, 6, 25}
+    };
+    for(KeyEquationSolver solver : {KEY_EQUATION_EUCLIDEAN, KEY_EQUATION_BERLEKAMP_MASSEY}) {
+        ReedSolomonDecoder decoder(solver);
+        std::unique_ptr<BitslicedDecoder> bitsliced(new BitslicedDecoder(solver));
+        for(const Mix& mix : mixes) {
+            // 1000 frames: 15 full groups and a group of 40
+            CodewordBatch batch(1000), reference(1000);
+            fill(gen, batch, mix.rate, mix.errors, mix.erasures);
+            memcpy(reference.symbols, batch.symbols, batch.count * CodewordBatch::stride);
+            memcpy(reference.erasure_masks, batch.erasure_masks, batch.count * sizeof(uint64_t));
+            bitsliced->decode_batch(batch);
+            decoder.decode_batch(reference);
+            for(size_t f = 0; f < batch.count; f++) {
+                CHECK(batch.status[f] == reference.status[f]);
+                CHECK(memcmp(batch.corrected_frame(f), reference.corrected_frame(f), 63) == 0);
+            }
+        }
+    }
+    return test_result("bitsliced");
+}
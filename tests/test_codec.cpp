@@ -0,0 +1,73 @@
+// RSCodec: RS63_42 encodes and decodes like the hand-written encoder and decode_frame (both
+// erasure forms), and other fields and rates round trip within their radius
+#include <vector>
+#include "test_common.h"
+
+// Encode, put 2e + f <= N - K errors and erasures at distinct positions, decode the list form
+template<class Codec>
+static void round_trip(std::mt19937& gen, int frames) {
+    using symbol = typename Codec::symbol;
+    for(int f = 0; f < frames; f++) {
+        std::vector<symbol> message(Codec::k), codeword(Codec::n), received, decoded(Codec::n);
+        for(auto& m : message) m = gen() % (Codec::field::order + 1);
+        Codec::encode(message.data(), codeword.data());
+        CHECK(std::equal(message.begin(), message.end(), codeword.begin()));
+        int erasures = gen() % (Codec::parity + 1), errors = (Codec::parity - erasures) / 2;
+        if(f % 2) errors = gen() % (errors + 1);
+        std::vector<int> positions(Codec::n);
+        for(int i = 0; i < Codec::n; i++) positions[i] = i;
+        std::shuffle(positions.begin(), positions.end(), gen);
+        received = codeword;
+        for(int e = 0; e < erasures; e++) received[positions[e]] = gen() % (Codec::field::order + 1);
+        for(int e = erasures; e < erasures + errors; e++) received[positions[e]] ^= 1 + gen() % Codec::field::order;
+        DecodeStatus status = Codec::decode(received.data(), positions.data(), erasures, decoded.data());
+        CHECK(status == DECODE_OK || status == DECODE_CORRECTED);
+        CHECK(decoded == codeword);
+    }
+}
+
+int main() {
+    std::mt19937 gen(20);
+    for(int j = 0; j <= 21; j++) CHECK(RS63_42::generator[j] == gen_poly[j]);
+
+    ReedSolomonDecoder decoder;
+    DecoderWorkspace ws;
+    ReedSolomonEncoder encoder;
+    int outcomes[decode_status_count] = {0};
+    for(int trial = 0; trial < 20000; trial++) {
+        uint8_t message[42], codeword[64], reference[64];
+        for(auto& m : message) m = gen() & 63;
+        RS63_42::encode(message, codeword);
+        encoder.encodeSystematic(message, reference);
+        CHECK(memcmp(codeword, reference, 63) == 0);
+
+        uint8_t received[64], a[64], b[64], c[64];
+        uint64_t mask = corrupt(gen, codeword, gen() % 14, gen() % 24, received);
+        if(trial % 100 == 3) received[gen() % 63] = 64 + gen() % 192;
+        int erasures[63], count = 0;
+        for(uint64_t m = mask; m != 0; m &= m - 1) erasures[count++] = __builtin_ctzll(m);
+        std::shuffle(erasures, erasures + count, gen);
+        DecodeStatus expected = decoder.decode_frame(received, mask, a, ws);
+        outcomes[expected]++;
+        CHECK(RS63_42::decode(received, mask, b) == expected && memcmp(a, b, 63) == 0);
+        CHECK(RS63_42::decode(received, erasures, count, c) == expected && memcmp(a, c, 63) == 0);
+    }
+    for(int s = 0; s < decode_status_count; s++) CHECK(outcomes[s] > 0);
+
+    // Erasure indices outside the code are malformed
+    uint8_t zero[64] = {0}, decoded[64];
+    int outside[2] = {3, 63};
+    CHECK(RS63_42::decode(zero, outside, 2, decoded) == DECODE_MALFORMED);
+    outside[1] = -1;
+    CHECK(RS63_42::decode(zero, outside, 2, decoded) == DECODE_MALFORMED);
+
+    // Table-driven GF(64) codes and the generic path of larger fields
+    round_trip<RS63_42>(gen, 5000);
+    round_trip<RSCodec<GF64Field, 63, 53, 1>>(gen, 5000);
+    round_trip<RSCodec<GF64Field, 40, 20, 3>>(gen, 5000);
+    round_trip<RSCodec<GaloisField<4, 0x13>, 15, 7, 1>>(gen, 5000);
+    round_trip<RSCodec<GaloisField<8, 0x11D>, 255, 223, 0>>(gen, 500);
+    round_trip<RSCodec<GaloisField<8, 0x11D>, 204, 188, 0>>(gen, 500);
+    round_trip<RSCodec<GaloisField<10, 0x409>, 600, 560, 1>>(gen, 200);
+    return test_result("codec");
+}
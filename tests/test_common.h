@@ -0,0 +1,68 @@
+#ifndef RS_TEST_COMMON_H
+#define RS_TEST_COMMON_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include "rs_decoder.h"
+#include "rs_encoder.h"
+
+// Shared helpers of the behavioral tests (make test)
+// A failed CHECK prints its location and the test goes on; test_result() prints the summary
+// and returns the exit status of the test program.
+
+static int test_checks = 0, test_failures = 0;
+
+#define CHECK(condition) \
+    do { \
+        test_checks++; \
+        if(!(condition)) { \
+            if(test_failures++ < 20) fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+        } \
+    } while(0)
+
+inline int test_result(const char* name) {
+    printf("%-16s %s (%d checks, %d failed)\n", name, test_failures == 0 ? "ok" : "FAILED", test_checks, test_failures);
+    return test_failures == 0 ? 0 : 1;
+}
+
+// Random systematic codeword of RS(63,42) (64 bytes, symbol 63 is 0)
+inline void random_codeword(std::mt19937& gen, uint8_t* codeword) {
+    uint8_t message[42];
+    for(auto& m : message) m = gen() & 63;
+    BatchEncoder::instance().encode(message, codeword);
+    codeword[63] = 0;
+}
+
+// Received word with errors symbol errors and erasures erased symbols at distinct random positions
+// among the first length symbols; the erased symbols get a random value (the decoders ignore it).
+// Returns the erasure mask.
+inline uint64_t corrupt(std::mt19937& gen, const uint8_t* codeword, int errors, int erasures, uint8_t* received,
+                        int length = 63) {
+    int positions[63];
+    for(int i = 0; i < length; i++) positions[i] = i;
+    std::shuffle(positions, positions + length, gen);
+    memcpy(received, codeword, 64);
+    uint64_t mask = 0;
+    for(int e = 0; e < erasures; e++) {
+        received[positions[e]] = gen() & 63;
+        mask |= 1ULL << positions[e];
+    }
+    for(int e = erasures; e < erasures + errors; e++) received[positions[e]] ^= 1 + gen() % 63;
+    return mask;
+}
+
+// Whether a word of 63 symbols is a codeword (all 21 syndromes zero)
+inline bool is_codeword(const uint8_t* word) {
+    alignas(32) uint8_t symbols[64] = {0}, syndromes[32];
+    memcpy(symbols, word, 63);
+    SyndromeTableEngine::instance().compute(symbols, syndromes);
+    for(int j = 0; j < 21; j++) {
+        if(syndromes[j] != 0) return false;
+    }
+    return true;
+}
+
+#endif
@@ -0,0 +1,53 @@
+// ConstantTimeDecoder: decode_frame (one lane) and decode_batch (64 bit-sliced lanes) give the
+// status and output of ReedSolomonDecoder::decode_frame for every kind of frame
+#include <memory>
+#include "rs_constant_time.h"
+#include "test_common.h"
+
+int main() {
+    std::mt19937 gen(23);
+    ReedSolomonDecoder decoder;
+    DecoderWorkspace ws;
+    std::unique_ptr<ConstantTimeDecoder> constant_time(new ConstantTimeDecoder());
+
+    // Round trips at the boundary 2e + f = 21 and 20
+    for(int erasures = 0; erasures <= 21; erasures++) {
+        for(int errors = (20 - erasures + 1) / 2; 2 * errors + erasures <= 21; errors++) {
+            for(int trial = 0; trial < 20; trial++) {
+                uint8_t codeword[64], received[64], decoded[64];
+                random_codeword(gen, codeword);
+                uint64_t mask = corrupt(gen, codeword, errors, erasures, received);
+                DecodeStatus status = constant_time->decode_frame(received, mask, decoded);
+                CHECK(status == DECODE_CORRECTED || (status == DECODE_OK && errors == 0));
+                CHECK(memcmp(decoded, codeword, 63) == 0);
+            }
+        }
+    }
+
+    // Random frames of every outcome, one by one and as a batch of 15 groups and a partial one
+    const size_t count = 1000;
+    CodewordBatch batch(count);
+    for(size_t f = 0; f < count; f++) {
+        uint8_t codeword[64];
+        random_codeword(gen, codeword);
+        batch.erasure_masks[f] = corrupt(gen, codeword, gen() % 14, f % 5 == 0 ? gen() % 30 : gen() % 12, batch.frame(f));
+        if(f % 40 == 1) batch.frame(f)[gen() % 63] |= 0x40;
+    }
+    std::unique_ptr<uint8_t[]> expected_frames(new uint8_t[count * 64]);
+    int outcomes[decode_status_count] = {0};
+    for(size_t f = 0; f < count; f++) {
+        uint8_t decoded[64];
+        DecodeStatus expected = decoder.decode_frame(batch.frame(f), batch.erasure_masks[f], &expected_frames[f * 64], ws);
+        outcomes[expected]++;
+        CHECK(constant_time->decode_frame(batch.frame(f), batch.erasure_masks[f], decoded) == expected);
+        CHECK(memcmp(decoded, &expected_frames[f * 64], 63) == 0);
+    }
+    for(int s = 0; s < decode_status_count; s++) CHECK(outcomes[s] > 0);
+    constant_time->decode_batch(batch);
+    for(size_t f = 0; f < count; f++) {
+        uint8_t decoded[64];
+        CHECK(batch.status[f] == decoder.decode_frame(batch.frame(f), batch.erasure_masks[f], decoded, ws));
+        CHECK(memcmp(batch.corrected_frame(f), &expected_frames[f * 64], 63) == 0);
+    }
+    return test_result("constant_time");
+}
@@ -0,0 +1,89 @@
+// DecodeContext: after any sequence of update_symbol and set_erasure calls, decode() gives the
+// status and output of decode_frame on the current frame; invalid values and positions
+#include "rs_context.h"
+#include "test_common.h"
+
+int main() {
+    std::mt19937 gen(18);
+    ReedSolomonDecoder decoder;
+    DecoderWorkspace ws;
+    DecodeContext context(decoder);
+    int outcomes[decode_status_count] = {0};
+    for(int trial = 0; trial < 5000; trial++) {
+        uint8_t codeword[64], received[64];
+        random_codeword(gen, codeword);
+        uint64_t mask = corrupt(gen, codeword, gen() % 12, gen() % 24, received);
+        context.load(received, mask);
+        for(int step = 0; step < 10; step++) {
+            int position = gen() % 63;
+            switch(gen() % 4) {
+                case 0:
+                    // A wrong symbol, or a symbol put back to its sent value
+                    received[position] = gen() % 2 ? gen() & 63 : codeword[position];
+                    CHECK(context.update_symbol(position, received[position]));
+                    break;
+                case 1:
+                    mask |= 1ULL << position;
+                    CHECK(context.set_erasure(position, true));
+                    break;
+                case 2:
+                    mask &= ~(1ULL << position);
+                    CHECK(context.set_erasure(position, false));
+                    break;
+                default:
+                    break;
+            }
+            uint8_t a[64], b[64];
+            DecodeStatus status = context.decode(a);
+            DecodeStatus expected = decoder.decode_frame(received, mask, b, ws);
+            outcomes[expected]++;
+            CHECK(status == expected && memcmp(a, b, 63) == 0);
+            CHECK(context.erasures() == mask && memcmp(context.received(), received, 63) == 0);
+            // The cached result
+            CHECK(context.decode(a) == expected && memcmp(a, b, 63) == 0);
+        }
+    }
+    CHECK(outcomes[DECODE_OK] > 0 && outcomes[DECODE_CORRECTED] > 0 && outcomes[DECODE_TOO_MANY_ERASURES] > 0 &&
+          outcomes[DECODE_UNCORRECTABLE] > 0);
+
+    uint8_t codeword[64], decoded[64];
+    random_codeword(gen, codeword);
+
+    // A value above 63 makes the frame malformed unless the symbol is erased
+    context.load(codeword, 0);
+    CHECK(context.update_symbol(10, 64));
+    CHECK(context.decode(decoded) == DECODE_MALFORMED);
+    CHECK(context.set_erasure(10, true));
+    DecodeStatus status = context.decode(decoded);
+    CHECK(status == DECODE_CORRECTED || status == DECODE_OK);
+    CHECK(memcmp(decoded, codeword, 63) == 0);
+    CHECK(context.set_erasure(10, false));
+    CHECK(context.decode(decoded) == DECODE_MALFORMED);
+    CHECK(context.update_symbol(10, codeword[10]));
+    CHECK(context.decode(decoded) == DECODE_OK);
+    uint8_t invalid[64];
+    memcpy(invalid, codeword, 64);
+    invalid[3] = 200;
+    context.load(invalid, 0);
+    CHECK(context.decode(decoded) == DECODE_MALFORMED);
+    context.load(invalid, 1ULL << 3);
+    CHECK(context.decode(decoded) != DECODE_MALFORMED && memcmp(decoded, codeword, 63) == 0);
+
+    // Positions outside 0~62 change nothing, return false and make the frame malformed until the
+    // next load, even after a decode of the unchanged frame was cached
+    for(int position : {-1, 63, 64, 1000}) {
+        context.load(codeword, 0);
+        CHECK(context.decode(decoded) == DECODE_OK);
+        CHECK(!context.update_symbol(position, 1));
+        CHECK(context.decode(decoded) == DECODE_MALFORMED);
+        CHECK(context.update_symbol(0, codeword[0]));
+        CHECK(context.decode(decoded) == DECODE_MALFORMED);
+        context.load(codeword, 0);
+        CHECK(!context.set_erasure(position, true));
+        CHECK(context.erasures() == 0);
+        CHECK(context.decode(decoded) == DECODE_MALFORMED);
+        context.load(codeword, 0);
+        CHECK(context.decode(decoded) == DECODE_OK);
+    }
+    return test_result("context");
+}
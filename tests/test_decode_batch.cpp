@@ -0,0 +1,102 @@
+// decode_frame, decode_batch and the vector decode(): round trips inside the decoding radius,
+// the statuses outside it, and the same results from every entry point
+#include <vector>
+#include "test_common.h"
+
+int main() {
+    std::mt19937 gen(1);
+    ReedSolomonDecoder decoder;
+    DecoderWorkspace ws;
+
+    // Every 2e + f <= 21 (e errors, f erasures) decodes back to the codeword
+    for(int erasures = 0; erasures <= 21; erasures++) {
+        for(int errors = 0; 2 * errors + erasures <= 21; errors++) {
+            for(int trial = 0; trial < 20; trial++) {
+                uint8_t codeword[64], received[64], decoded[64];
+                random_codeword(gen, codeword);
+                uint64_t mask = corrupt(gen, codeword, errors, erasures, received);
+                DecodeStatus status = decoder.decode_frame(received, mask, decoded, ws);
+                CHECK(status == DECODE_CORRECTED || (status == DECODE_OK && errors == 0));
+                if(errors + erasures == 0) CHECK(status == DECODE_OK);
+                CHECK(memcmp(decoded, codeword, 63) == 0);
+            }
+        }
+    }
+
+    // One past the radius (2e + f = 22 and 23) a frame is either given up, with the received
+    // word copied through and its erasures set to 0, or decoded to another codeword
+    for(int erasures = 0; erasures <= 21; erasures++) {
+        for(int errors = (22 - erasures + 1) / 2; 2 * errors + erasures <= 23; errors++) {
+            for(int trial = 0; trial < 20; trial++) {
+                uint8_t codeword[64], received[64], decoded[64];
+                random_codeword(gen, codeword);
+                uint64_t mask = corrupt(gen, codeword, errors, erasures, received);
+                DecodeStatus status = decoder.decode_frame(received, mask, decoded, ws);
+                CHECK(status == DECODE_CORRECTED || status == DECODE_UNCORRECTABLE);
+                if(status == DECODE_CORRECTED) CHECK(is_codeword(decoded) && memcmp(decoded, codeword, 63) != 0);
+                else {
+                    for(int i = 0; i < 63; i++) CHECK(decoded[i] == (((mask >> i) & 1) ? 0 : received[i]));
+                }
+            }
+        }
+    }
+
+    // More than 21 erasures: too many unless the word with the erased symbols set to 0 is a codeword
+    for(int erasures = 22; erasures <= 63; erasures++) {
+        uint8_t codeword[64], received[64], decoded[64];
+        random_codeword(gen, codeword);
+        uint64_t mask = corrupt(gen, codeword, 0, erasures, received);
+        uint8_t zeroed[64];
+        for(int i = 0; i < 64; i++) zeroed[i] = ((mask >> i) & 1) ? 0 : received[i];
+        DecodeStatus expected = is_codeword(zeroed) ? DECODE_OK : DECODE_TOO_MANY_ERASURES;
+        CHECK(decoder.decode_frame(received, mask, decoded, ws) == expected);
+        uint8_t zero[64] = {0};
+        mask = corrupt(gen, zero, 0, erasures, received);
+        CHECK(decoder.decode_frame(received, mask, decoded, ws) == DECODE_OK);
+        CHECK(is_codeword(decoded));
+    }
+
+    // decode_batch gives every frame the status and output of decode_frame, with the default
+    // stride and with a wider one
+    const size_t count = 1000, stride = 80;
+    CodewordBatch batch(count);
+    std::vector<uint8_t> symbols(count * stride), corrected(count * stride), status(count);
+    for(size_t f = 0; f < count; f++) {
+        uint8_t codeword[64];
+        random_codeword(gen, codeword);
+        batch.erasure_masks[f] = corrupt(gen, codeword, gen() % 15, gen() % 26, batch.frame(f));
+        if(f % 50 == 7) batch.frame(f)[gen() % 63] |= 0x40;
+        memcpy(&symbols[f * stride], batch.frame(f), 64);
+    }
+    decoder.decode_batch(batch);
+    decoder.decode_batch(symbols.data(), batch.erasure_masks, count, corrected.data(), status.data(), stride);
+    int outcomes[decode_status_count] = {0};
+    for(size_t f = 0; f < count; f++) {
+        uint8_t decoded[64];
+        DecodeStatus expected = decoder.decode_frame(batch.frame(f), batch.erasure_masks[f], decoded, ws);
+        outcomes[expected]++;
+        CHECK(batch.status[f] == expected && memcmp(batch.corrected_frame(f), decoded, 63) == 0);
+        CHECK(status[f] == expected && memcmp(&corrected[f * stride], decoded, 63) == 0);
+    }
+    // The batch reaches every outcome
+    for(int s = 0; s < decode_status_count; s++) CHECK(outcomes[s] > 0);
+
+    // The vector decode() is decode_frame on GF64 symbols
+    for(int trial = 0; trial < 200; trial++) {
+        uint8_t codeword[64], received[64], decoded[64];
+        random_codeword(gen, codeword);
+        uint64_t mask = corrupt(gen, codeword, gen() % 13, gen() % 23, received);
+        std::vector<GF64> word(63);
+        std::vector<bool> erased(63);
+        for(int i = 0; i < 63; i++) {
+            word[i] = GF64(received[i]);
+            erased[i] = (mask >> i) & 1;
+        }
+        GF64_poly result;
+        DecodeStatus status = decoder.decode(word, erased, result);
+        CHECK(status == decoder.decode_frame(received, mask, decoded, ws));
+        for(int i = 0; i < 63; i++) CHECK(result.get_coefficient(i).get_value() == decoded[i]);
+        CHECK(decoder.decode(word, erased).first == (status == DECODE_OK || status == DECODE_CORRECTED));
+    }
+    return test_result("decode_batch");
+}
@@ -0,0 +1,106 @@
+// Encoders: systematic codewords carry the message verbatim and lie in the code spanned by the
+// non-systematic encode() (message(x) * g(x)), BatchEncoder matches encodeSystematic and
+// encodeShortened, and encode_batch matches one-by-one encode() for any thread count and strides
+#include <vector>
+#include "test_common.h"
+
+int main() {
+    std::mt19937 gen(8);
+    ReedSolomonEncoder encoder;
+    const BatchEncoder& batch_encoder = BatchEncoder::instance();
+
+    // g(x) has the roots a^1 ~ a^21
+    GF64_poly generator = encoder.createGeneratorPolynomial();
+    CHECK(generator.get_degree() == 21);
+    for(int j = 1; j <= 21; j++) CHECK(generator(GF64(pow_table[j])).get_value() == 0);
+    CHECK(generator(GF64(pow_table[22])).get_value() != 0);
+
+    for(int trial = 0; trial < 2000; trial++) {
+        uint8_t message[42], codeword[64] = {0}, table[64] = {0};
+        for(auto& m : message) m = gen() & 63;
+        encoder.encodeSystematic(message, codeword);
+        CHECK(memcmp(codeword, message, 42) == 0);
+        CHECK(is_codeword(codeword));
+        batch_encoder.encode(message, table);
+        CHECK(memcmp(table, codeword, 63) == 0);
+
+        // The vector form gives the same codeword
+        std::vector<GF64> message_vector(42), codeword_vector;
+        for(int i = 0; i < 42; i++) message_vector[i] = GF64(message[i]);
+        codeword_vector = encoder.encodeSystematic(message_vector);
+        bool same = codeword_vector.size() == 63;
+        for(int i = 0; same && i < 63; i++) same = codeword_vector[i].get_value() == codeword[i];
+        CHECK(same);
+        CHECK(verify_codeword(codeword_vector));
+
+        // The systematic codeword is q(x) * g(x) for the quotient q(x), so encode(q) gives it back
+        GF64_poly quotient = GF64_poly(codeword_vector) / generator;
+        std::vector<GF64> q(42);
+        for(int i = 0; i < 42; i++) q[i] = quotient.get_coefficient(i);
+        std::vector<GF64> product = encoder.encode(q);
+        same = true;
+        for(int i = 0; i < 63; i++) same &= product[i].get_value() == codeword[i];
+        CHECK(same);
+        // encode() of the message itself is a codeword too, but not a systematic one
+        std::vector<GF64> nonsystematic = encoder.encode(message_vector);
+        CHECK(verify_codeword(nonsystematic));
+        std::vector<int> ints(message, message + 42);
+        std::vector<GF64> from_ints = encoder.encodeFromInts(ints, trial % 2 == 0);
+        same = true;
+        for(int i = 0; i < 63; i++) same &= from_ints[i].get_value() == (trial % 2 == 0 ? codeword[i] : nonsystematic[i].get_value());
+        CHECK(same);
+
+        // Linearity: the codeword of a + b is the sum of the codewords
+        uint8_t other[42], sum[42], other_codeword[64], sum_codeword[64];
+        for(int i = 0; i < 42; i++) {
+            other[i] = gen() & 63;
+            sum[i] = message[i] ^ other[i];
+        }
+        batch_encoder.encode(other, other_codeword);
+        batch_encoder.encode(sum, sum_codeword);
+        same = true;
+        for(int i = 0; i < 63; i++) same &= sum_codeword[i] == (codeword[i] ^ other_codeword[i]);
+        CHECK(same);
+
+        // Shortened: both encoders agree, and the codeword is the full codeword of the zero-padded message
+        int length = 1 + gen() % 42;
+        uint8_t padded[42] = {0}, shortened[64], full[64];
+        memcpy(padded, message, length);
+        encoder.encodeShortened(message, length, shortened);
+        batch_encoder.encode(message, table, length);
+        CHECK(memcmp(shortened, table, length + 21) == 0);
+        encoder.encodeSystematic(padded, full);
+        CHECK(memcmp(shortened, full, length) == 0 && memcmp(shortened + length, full + 42, 21) == 0);
+
+        // Symbols are taken modulo 64 in the message and the parity alike
+        uint8_t wide[42];
+        for(int i = 0; i < 42; i++) wide[i] = message[i] | (gen() & 0xC0);
+        encoder.encodeSystematic(wide, table);
+        CHECK(memcmp(table, codeword, 63) == 0);
+        memset(table, 0, sizeof(table));
+        batch_encoder.encode(wide, table);
+        CHECK(memcmp(table, codeword, 63) == 0);
+    }
+
+    // encode_batch over threads and strides: the same bytes as one encode() per message, and the
+    // padding of every codeword slot untouched
+    for(size_t count : {0, 1, 5, 7, 1000}) {
+        for(size_t message_stride : {42, 50}) {
+            for(size_t codeword_stride : {63, 64, 70}) {
+                std::vector<uint8_t> messages(count * message_stride + 1);
+                for(auto& m : messages) m = gen() & 63;
+                std::vector<uint8_t> expected(count * codeword_stride + 1, 0xAA);
+                for(size_t f = 0; f < count; f++) {
+                    batch_encoder.encode(&messages[f * message_stride], &expected[f * codeword_stride]);
+                }
+                for(int threads : {1, 2, 3, 8}) {
+                    std::vector<uint8_t> codewords(count * codeword_stride + 1, 0xAA);
+                    batch_encoder.encode_batch(messages.data(), count, codewords.data(), message_stride,
+                                               codeword_stride, threads);
+                    CHECK(codewords == expected);
+                }
+            }
+        }
+    }
+    return test_result("encoder");
+}
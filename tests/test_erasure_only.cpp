@@ -0,0 +1,43 @@
+// The erasure-only path of correctFrame: frames with 1~21 erasures and no errors are filled in
+// without the key equation, and frames with errors besides the erasures fall back to it. Both
+// are compared with RS63_42::decode, which always runs the key equation.
+#include "test_common.h"
+
+int main() {
+    std::mt19937 gen(16);
+    for(KeyEquationSolver solver : {KEY_EQUATION_EUCLIDEAN, KEY_EQUATION_BERLEKAMP_MASSEY}) {
+        ReedSolomonDecoder decoder(solver);
+        DecoderWorkspace ws;
+        for(int erasures = 1; erasures <= 21; erasures++) {
+            // Erasures only (the erased values are random, so some may be right already)
+            for(int trial = 0; trial < 100; trial++) {
+                uint8_t codeword[64], received[64], decoded[64], reference[64];
+                random_codeword(gen, codeword);
+                uint64_t mask = corrupt(gen, codeword, 0, erasures, received);
+                DecodeStatus status = decoder.decode_frame(received, mask, decoded, ws);
+                CHECK(status == DECODE_CORRECTED || status == DECODE_OK);
+                CHECK(memcmp(decoded, codeword, 63) == 0);
+                CHECK(RS63_42::decode(received, mask, reference) == status && memcmp(reference, decoded, 63) == 0);
+            }
+            // Erasures with errors: inside the radius they are corrected, past it the result is
+            // that of the key equation
+            for(int trial = 0; trial < 100; trial++) {
+                uint8_t codeword[64], received[64], decoded[64], reference[64];
+                random_codeword(gen, codeword);
+                int errors = 1 + gen() % ((23 - erasures) / 2 + 1);
+                uint64_t mask = corrupt(gen, codeword, errors, erasures, received);
+                DecodeStatus status = decoder.decode_frame(received, mask, decoded, ws);
+                if(2 * errors + erasures <= 21) CHECK(status == DECODE_CORRECTED && memcmp(decoded, codeword, 63) == 0);
+                CHECK(RS63_42::decode(received, mask, reference) == status && memcmp(reference, decoded, 63) == 0);
+            }
+        }
+        // An erased symbol is set to 0: OK if that is its value, otherwise it is filled in
+        uint8_t zero[64] = {0}, codeword[64], decoded[64];
+        zero[5] = 17;
+        CHECK(decoder.decode_frame(zero, 1ULL << 5, decoded, ws) == DECODE_OK && decoded[5] == 0);
+        do random_codeword(gen, codeword); while(codeword[5] == 0);
+        CHECK(decoder.decode_frame(codeword, 1ULL << 5, decoded, ws) == DECODE_CORRECTED);
+        CHECK(memcmp(decoded, codeword, 63) == 0);
+    }
+    return test_result("erasure_only");
+}
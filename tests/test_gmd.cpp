@@ -0,0 +1,68 @@
+// GMDDecoder: the first trial is decode_frame, errors on the least reliable symbols are found
+// past the hard-decision radius, and the statuses of zero-syndrome, too-many-erasures and
+// malformed frames match decode_frame
+#include "rs_gmd.h"
+#include "test_common.h"
+
+int main() {
+    std::mt19937 gen(19);
+    std::uniform_real_distribution<float> uniform(0.5f, 1.0f);
+    ReedSolomonDecoder decoder;
+    DecoderWorkspace ws;
+    GMDDecoder gmd(decoder);
+
+    // A frame decode_frame decodes is decoded the same way in one trial
+    for(int trial = 0; trial < 5000; trial++) {
+        uint8_t codeword[64], received[64], a[64], b[64];
+        random_codeword(gen, codeword);
+        uint64_t mask = corrupt(gen, codeword, gen() % 14, gen() % 23, received);
+        float reliability[63];
+        for(float& r : reliability) r = uniform(gen);
+        int trials = -1;
+        DecodeStatus status = gmd.decode(received, reliability, mask, a, &trials);
+        DecodeStatus expected = decoder.decode_frame(received, mask, b, ws);
+        if(expected == DECODE_OK || expected == DECODE_CORRECTED) {
+            CHECK(status == expected && memcmp(a, b, 63) == 0);
+            CHECK(trials == 1);
+        }
+        else CHECK(status != DECODE_OK && trials >= 1);
+        if(status == DECODE_CORRECTED) CHECK(is_codeword(a));
+    }
+
+    // 11~20 errors (past t = 10) on the least reliable symbols, with and without hard erasures.
+    // An early trial may still decode to another codeword (the first codeword found wins),
+    // but nearly every frame gets back the one that was sent.
+    int recovered = 0;
+    for(int errors = 11; errors <= 20; errors++) {
+        for(int trial = 0; trial < 100; trial++) {
+            uint8_t codeword[64], received[64], decoded[64];
+            random_codeword(gen, codeword);
+            // GMD erases up to (21 - f) & ~1 symbols on top of f hard erasures
+            int erasures = trial % 2 ? (21 - errors) / 2 : 0;
+            uint64_t mask = corrupt(gen, codeword, errors, erasures, received);
+            float reliability[63];
+            for(int i = 0; i < 63; i++) reliability[i] = received[i] != codeword[i] && !((mask >> i) & 1) ? uniform(gen) - 0.5f : uniform(gen);
+            int trials = 0;
+            CHECK(gmd.decode(received, reliability, mask, decoded, &trials) == DECODE_CORRECTED);
+            CHECK(is_codeword(decoded));
+            recovered += memcmp(decoded, codeword, 63) == 0;
+        }
+    }
+    CHECK(recovered >= 950);
+
+    float reliability[63];
+    for(float& r : reliability) r = 1;
+    uint8_t zero[64] = {0}, received[64], decoded[64];
+    // More than 21 erasures: OK when the syndromes are zero, too many otherwise
+    uint64_t mask = corrupt(gen, zero, 0, 30, received);
+    CHECK(gmd.decode(received, reliability, mask, decoded) == DECODE_OK);
+    uint8_t codeword[64];
+    do random_codeword(gen, codeword); while(codeword[0] == 0);
+    CHECK(gmd.decode(codeword, reliability, (1ULL << 22) - 1, decoded) == DECODE_TOO_MANY_ERASURES);
+    // Malformed
+    memcpy(received, codeword, 64);
+    received[7] = 64;
+    CHECK(gmd.decode(received, reliability, 0, decoded) == DECODE_MALFORMED);
+    CHECK(gmd.decode(received, reliability, 1ULL << 7, decoded) == DECODE_CORRECTED && memcmp(decoded, codeword, 63) == 0);
+    return test_result("gmd");
+}
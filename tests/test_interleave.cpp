@@ -0,0 +1,87 @@
+// InterleavedCodec: the tile transpose, the channel layout, bursts within D * t errors or D * 21
+// erasures, and bursts a little longer that only decode once the erasures are propagated
+#include <vector>
+#include "rs_interleave.h"
+#include "test_common.h"
+
+int main() {
+    std::mt19937 gen(22);
+    for(int rows : {1, 7, 8, 9, 63, 64, 130}) {
+        for(int cols : {1, 8, 63, 64, 70}) {
+            std::vector<uint8_t> a(rows * 80), b(cols * 150, 0);
+            for(auto& x : a) x = gen();
+            transpose_symbols(a.data(), 80, b.data(), 150, rows, cols);
+            bool same = true;
+            for(int r = 0; r < rows; r++) {
+                for(int c = 0; c < cols; c++) same &= b[c * 150 + r] == a[r * 80 + c];
+            }
+            CHECK(same);
+        }
+    }
+
+    ReedSolomonEncoder encoder;
+    ReedSolomonDecoder decoder;
+    DecoderWorkspace ws;
+    for(int depth : {1, 4, 8, 16}) {
+        InterleavedCodec codec(depth);
+        CHECK(codec.get_depth() == depth && codec.block_size() == depth * 63);
+        int plain_failures = 0, failures = 0;
+        for(int trial = 0; trial < 300; trial++) {
+            std::vector<uint8_t> messages(depth * 42), block(depth * 63), flags(depth * 63, 0);
+            std::vector<uint8_t> codewords(depth * 64), status(depth);
+            for(auto& m : messages) m = gen() & 63;
+            codec.encode(messages.data(), block.data());
+            // Channel symbol j * depth + c is symbol j of codeword c
+            for(int c = 0; c < depth; c++) {
+                uint8_t codeword[64];
+                encoder.encodeSystematic(&messages[c * 42], codeword);
+                for(int j = 0; j < 63; j++) CHECK(block[j * depth + c] == codeword[j]);
+            }
+            std::vector<uint8_t> sent = block;
+            // 0: errors within D * t, 1: flagged burst within D * 21, 2: errors a little past D * t
+            int kind = trial % 3;
+            int burst = kind == 0 ? 1 + gen() % (10 * depth) : kind == 1 ? 1 + gen() % (21 * depth) : 10 * depth + 1 + gen() % depth;
+            int start = gen() % (depth * 63 - burst + 1);
+            for(int p = start; p < start + burst; p++) {
+                block[p] ^= 1 + gen() % 63;
+                if(kind == 1) flags[p] = 1;
+            }
+            int failed = codec.decode(block.data(), flags.data(), codewords.data(), status.data());
+            int count = 0;
+            for(int c = 0; c < depth; c++) {
+                bool decoded = status[c] == DECODE_OK || status[c] == DECODE_CORRECTED;
+                count += !decoded;
+                if(kind < 2) CHECK(decoded);
+                if(decoded) {
+                    for(int j = 0; j < 63; j++) CHECK(codewords[c * 64 + j] == sent[j * depth + c]);
+                }
+                CHECK(codewords[c * 64 + 63] == 0);
+                // The same codeword decoded on its own
+                uint8_t received[64], alone[64];
+                uint64_t mask = 0;
+                for(int j = 0; j < 63; j++) {
+                    received[j] = block[j * depth + c];
+                    if(flags[j * depth + c]) mask |= 1ULL << j;
+                }
+                DecodeStatus result = decoder.decode_frame(received, mask, alone, ws);
+                if(kind == 2) plain_failures += result != DECODE_OK && result != DECODE_CORRECTED;
+            }
+            CHECK(failed == count);
+            if(kind == 2) failures += failed;
+        }
+        // With depth > 1, a burst past D * t leaves some codewords with t + 1 errors: decoded on
+        // their own they fail, and the erasures propagated from their neighbours fix most of them
+        // (60~90% here, less for bursts at the edges of the block)
+        if(depth > 1) CHECK(plain_failures > 0 && failures * 2 < plain_failures);
+        else CHECK(failures == plain_failures);
+    }
+    // No erasure flags at all
+    InterleavedCodec codec(4);
+    std::vector<uint8_t> messages(4 * 42), block(4 * 63), codewords(4 * 64), status(4);
+    for(auto& m : messages) m = gen() & 63;
+    codec.encode(messages.data(), block.data());
+    block[5] ^= 1;
+    CHECK(codec.decode(block.data(), nullptr, codewords.data(), status.data()) == 0);
+    CHECK(status[1] == DECODE_CORRECTED && status[0] == DECODE_OK && memcmp(&codewords[0], &messages[0], 42) == 0);
+    return test_result("interleave");
+}
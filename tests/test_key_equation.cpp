@@ -0,0 +1,46 @@
+// The Euclidean and Berlekamp-Massey key equation solvers: both decode every frame inside
+// the radius, and they agree on the status and output of every frame, inside it or not
+#include "test_common.h"
+
+int main() {
+    std::mt19937 gen(5);
+    ReedSolomonDecoder euclid(KEY_EQUATION_EUCLIDEAN), bm(KEY_EQUATION_BERLEKAMP_MASSEY);
+    DecoderWorkspace ws;
+    CHECK(euclid.get_key_equation_solver() == KEY_EQUATION_EUCLIDEAN);
+    CHECK(bm.get_key_equation_solver() == KEY_EQUATION_BERLEKAMP_MASSEY);
+
+    // 2e + f <= 21 with both solvers, the boundary 2e + f = 21 and 20 included
+    for(int erasures = 0; erasures <= 21; erasures++) {
+        for(int errors = 0; 2 * errors + erasures <= 21; errors++) {
+            for(int trial = 0; trial < 20; trial++) {
+                uint8_t codeword[64], received[64], a[64], b[64];
+                random_codeword(gen, codeword);
+                uint64_t mask = corrupt(gen, codeword, errors, erasures, received);
+                DecodeStatus sa = euclid.decode_frame(received, mask, a, ws);
+                DecodeStatus sb = bm.decode_frame(received, mask, b, ws);
+                CHECK(sa == DECODE_CORRECTED || (sa == DECODE_OK && errors == 0));
+                CHECK(sa == sb);
+                CHECK(memcmp(a, codeword, 63) == 0 && memcmp(b, codeword, 63) == 0);
+            }
+        }
+    }
+
+    // Outside the radius the solvers give up on the same frames and find the same codewords
+    int outcomes[decode_status_count] = {0};
+    for(int trial = 0; trial < 20000; trial++) {
+        uint8_t codeword[64], received[64], a[64], b[64];
+        random_codeword(gen, codeword);
+        int erasures = gen() % 24, errors = (21 - std::min(erasures, 21)) / 2 + gen() % 4;
+        uint64_t mask = corrupt(gen, codeword, errors, erasures, received);
+        DecodeStatus sa = euclid.decode_frame(received, mask, a, ws);
+        DecodeStatus sb = bm.decode_frame(received, mask, b, ws);
+        outcomes[sa]++;
+        CHECK(sa == sb && memcmp(a, b, 63) == 0);
+    }
+    CHECK(outcomes[DECODE_CORRECTED] > 0 && outcomes[DECODE_UNCORRECTABLE] > 0 && outcomes[DECODE_TOO_MANY_ERASURES] > 0);
+
+    // The solver can be switched on a decoder
+    euclid.set_key_equation_solver(KEY_EQUATION_BERLEKAMP_MASSEY);
+    CHECK(euclid.get_key_equation_solver() == KEY_EQUATION_BERLEKAMP_MASSEY);
+    return test_result("key_equation");
+}
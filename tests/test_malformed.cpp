@@ -0,0 +1,109 @@
+// Malformed input: every decoder reports DECODE_MALFORMED for a symbol above 63 that is not
+// erased (and decodes it once it is erased), for out-of-range lengths and erasure indices,
+// and nothing exits or throws on the decode path
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "rs_bitsliced.h"
+#include "rs_constant_time.h"
+#include "rs_context.h"
+#include "rs_gmd.h"
+#include "test_common.h"
+
+int main() {
+    std::mt19937 gen(25);
+    ReedSolomonDecoder decoder;
+    DecoderWorkspace ws;
+    std::unique_ptr<BitslicedDecoder> bitsliced(new BitslicedDecoder());
+    std::unique_ptr<ConstantTimeDecoder> constant_time(new ConstantTimeDecoder());
+    DecodeContext context(decoder);
+    GMDDecoder gmd(decoder);
+    float reliability[63];
+    for(float& r : reliability) r = 1;
+
+    // Frame f % 3: 0 clean, 1 an unerased symbol above 63, 2 the same symbol erased
+    const size_t count = 150;
+    CodewordBatch batch(count), reference(count);
+    std::vector<DecodeStatus> expected(count);
+    for(size_t f = 0; f < count; f++) {
+        uint8_t codeword[64], received[64], decoded[64];
+        random_codeword(gen, codeword);
+        int position;
+        do position = gen() % 63; while(codeword[position] == 0);
+        memcpy(received, codeword, 64);
+        uint64_t mask = 0;
+        if(f % 3 > 0) received[position] |= 64 << (gen() % 2);
+        if(f % 3 == 2) mask = 1ULL << position;
+        expected[f] = f % 3 == 0 ? DECODE_OK : f % 3 == 1 ? DECODE_MALFORMED : DECODE_CORRECTED;
+        memcpy(batch.frame(f), received, 64);
+        batch.erasure_masks[f] = mask;
+
+        CHECK(decoder.decode_frame(received, mask, decoded, ws) == expected[f]);
+        if(f % 3 == 1) {
+            // Copied through with the symbols masked to 6 bits
+            for(int i = 0; i < 63; i++) CHECK(decoded[i] == (received[i] & 63));
+        }
+        else CHECK(memcmp(decoded, codeword, 63) == 0);
+        CHECK(constant_time->decode_frame(received, mask, decoded) == expected[f]);
+        context.load(received, mask);
+        CHECK(context.decode(decoded) == expected[f]);
+        CHECK(gmd.decode(received, reliability, mask, decoded) == expected[f]);
+        CHECK(RS63_42::decode(received, mask, decoded) == expected[f]);
+        CHECK(RS63_42::decode(received, &position, f % 3 == 2 ? 1 : 0, decoded) == expected[f]);
+        // Shortened: the same symbol in a full-length frame
+        CHECK(decoder.decode_shortened(received, 63, mask, decoded, ws) == expected[f]);
+        if(f % 3 == 1) {
+            // Putting the right value back through the context clears it
+            CHECK(context.update_symbol(position, codeword[position]));
+            CHECK(context.decode(decoded) == DECODE_OK);
+        }
+    }
+    memcpy(reference.symbols, batch.symbols, count * CodewordBatch::stride);
+    memcpy(reference.erasure_masks, batch.erasure_masks, count * sizeof(uint64_t));
+    decoder.decode_batch(reference);
+    for(size_t f = 0; f < count; f++) CHECK(reference.status[f] == expected[f]);
+    bitsliced->decode_batch(batch);
+    for(size_t f = 0; f < count; f++) CHECK(batch.status[f] == expected[f]);
+    constant_time->decode_batch(batch);
+    for(size_t f = 0; f < count; f++) CHECK(batch.status[f] == expected[f]);
+
+    // Lengths and erasure indices out of range
+    uint8_t zero[64] = {0}, decoded[64];
+    CHECK(decoder.decode_shortened(zero, 21, 0, decoded, ws) == DECODE_MALFORMED);
+    CHECK(decoder.decode_shortened(zero, 64, 0, decoded, ws) == DECODE_MALFORMED);
+    CHECK(decoder.decode_shortened(zero, 22, 0, decoded, ws) == DECODE_OK);
+    int erasures[2] = {70, 1};
+    CHECK(RS63_42::decode(zero, erasures, 2, decoded) == DECODE_MALFORMED);
+    GF64_poly result;
+    CHECK(decoder.decode(std::vector<GF64>(10), std::vector<bool>(), result) == DECODE_MALFORMED);
+    CHECK(decoder.decode(std::vector<GF64>(64), std::vector<bool>(), result) == DECODE_MALFORMED);
+    // All erased: zero syndromes; all but one erased: too many erasures
+    std::vector<bool> erased(63, true);
+    std::vector<GF64> word(63);
+    word[3] = GF64(5);
+    CHECK(decoder.decode(word, erased, result) == DECODE_OK);
+    erased[3] = false;
+    CHECK(decoder.decode(word, erased, result) == DECODE_TOO_MANY_ERASURES);
+
+    // Status names
+    CHECK(std::string(decode_status_name(DECODE_OK)) == "ok");
+    CHECK(std::string(decode_status_name(DECODE_MALFORMED)) == "malformed");
+    CHECK(std::string(decode_status_name((DecodeStatus)99)) == "unknown");
+
+    // Polynomial division by zero: divide() reports it, the operators throw
+    GF64_poly quotient, remainder, a(std::vector<GF64>{GF64(1), GF64(2)});
+    CHECK(!a.divide(GF64_poly(), quotient, remainder));
+    bool thrown = false;
+    try {
+        a / GF64_poly();
+    }
+    catch(const std::invalid_argument&) {
+        thrown = true;
+    }
+    CHECK(thrown);
+    GF64_poly three(std::vector<GF64>{GF64(3)});
+    CHECK(a.divide(three, quotient, remainder));
+    CHECK((quotient * three + remainder).get_coefficient(1).get_value() == 2 && remainder.is_zero());
+    return test_result("malformed");
+}
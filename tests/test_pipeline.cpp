@@ -0,0 +1,143 @@
+// StreamDecoder: many more chunks than the pool holds, through several workers, give the same
+// output, byte for byte and in input order, as a one-thread run and as decoding every frame on its
+// own, in text (full and shortened) and binary mode; malformed and truncated trailing frames, and
+// a binary stream with a bad header
+#include <string>
+#include <unistd.h>
+#include <vector>
+#include "rs_pipeline.h"
+#include "test_common.h"
+
+// Run a stream decoder from input to the returned output, errors gets what it printed to stderr
+static std::string run_stream(const std::string& input, int threads, size_t frames_per_chunk, bool binary,
+                              int length, bool& valid, std::string& errors) {
+    FILE* in = tmpfile();
+    FILE* out = tmpfile();
+    FILE* err = tmpfile();
+    fwrite(input.data(), 1, input.size(), in);
+    rewind(in);
+    fflush(stderr);
+    int saved_stderr = dup(2);
+    dup2(fileno(err), 2);
+    StreamDecoder decoder(RS_KEY_EQUATION_SOLVER, threads, frames_per_chunk, binary, length);
+    size_t frames;
+    valid = decoder.run(in, out, frames);
+    fflush(stderr);
+    dup2(saved_stderr, 2);
+    close(saved_stderr);
+    std::string output, text;
+    std::vector<char> buffer(1 << 16);
+    size_t size;
+    rewind(out);
+    while((size = fread(buffer.data(), 1, buffer.size(), out)) > 0) output.append(buffer.data(), size);
+    rewind(err);
+    while((size = fread(buffer.data(), 1, buffer.size(), err)) > 0) text.append(buffer.data(), size);
+    errors = text;
+    fclose(in);
+    fclose(out);
+    fclose(err);
+    return output;
+}
+
+// Expected output line of a frame decoded on its own
+static std::string expected_line(DecodeStatus status, const uint8_t* codeword, int length) {
+    if(status == DECODE_TOO_MANY_ERASURES) return "Error: Erasure locator polynomial degree exceeds 21\n";
+    if(status != DECODE_OK && status != DECODE_CORRECTED) return "give up\n";
+    std::string line;
+    for(int i = 0; i < length; i++) line += std::to_string(codeword[i]) + " ";
+    return line + "\n";
+}
+
+int main() {
+    std::mt19937 gen(10);
+    ReedSolomonDecoder decoder;
+    DecoderWorkspace ws;
+    bool valid;
+    std::string errors;
+
+    // Text: 3000 frames of every outcome, with arbitrary line breaks, one malformed frame and an
+    // incomplete frame at the end
+    for(int shortening : {0, 13}) {
+        const int length = 63 - shortening, frames = 3000, malformed = 1234;
+        std::string input, expected;
+        for(int f = 0; f < frames; f++) {
+            uint8_t codeword[64], received[64], decoded[64];
+            random_codeword(gen, codeword);
+            if(shortening > 0) {
+                uint8_t message[42] = {0}, full[64];
+                for(int i = 0; i < 42 - shortening; i++) message[i] = gen() & 63;
+                BatchEncoder::instance().encode(message, full, 42 - shortening);
+                memcpy(codeword, full, 64);
+            }
+            uint64_t mask = corrupt(gen, codeword, gen() % 13, f % 7 == 0 ? gen() % 26 : gen() % 8, received, length);
+            DecodeStatus status = shortening > 0 ? decoder.decode_shortened(received, length, mask, decoded, ws)
+                                                 : decoder.decode_frame(received, mask, decoded, ws);
+            expected += f == malformed ? "give up\n" : expected_line(status, decoded, length);
+            for(int i = 0; i < length; i++) {
+                if(f == malformed && i == 5) input += "64";
+                else input += (mask >> i) & 1 ? std::string("*") : std::to_string(received[i]);
+                input += gen() % 17 == 0 ? "\n" : gen() % 5 == 0 ? " \t " : " ";
+            }
+            input += "\n";
+        }
+        // The missing symbols of the last frame are 0
+        input += "1 2 3\n";
+        expected += "give up\n";
+
+        std::string single = run_stream(input, 1, 512, false, length, valid, errors);
+        CHECK(valid && single == expected);
+        CHECK(errors.find("(frame 1234, symbol 5): symbol out of range 0~63") != std::string::npos);
+        CHECK(errors.find("(frame 3000, symbol 3): incomplete frame at the end of the input") != std::string::npos);
+        std::string single_errors = errors;
+        // The pool holds 4 chunks per worker, so every run below recycles each chunk many times
+        for(int threads : {2, 4, 7}) {
+            for(size_t frames_per_chunk : {1, 3, 64}) {
+                CHECK(run_stream(input, threads, frames_per_chunk, false, length, valid, errors) == single);
+                CHECK(valid && errors == single_errors);
+            }
+        }
+    }
+
+    // Binary: the same, a truncated record at the end is dropped with a warning
+    const int frames = 5000;
+    std::string input(frame_header_size, '\0'), expected(frame_header_size, '\0');
+    make_frame_header((uint8_t*)&input[0]);
+    make_frame_header((uint8_t*)&expected[0]);
+    for(int f = 0; f < frames; f++) {
+        uint8_t codeword[64], received[64], decoded[64], record[frame_record_size];
+        random_codeword(gen, codeword);
+        uint64_t mask = corrupt(gen, codeword, gen() % 13, f % 7 == 0 ? gen() % 26 : gen() % 8, received);
+        for(int i = 0; i < 63; i++) {
+            if((mask >> i) & 1) received[i] = 0;
+        }
+        pack_frame(received, mask, record);
+        input.append((const char*)record, frame_record_size);
+        DecodeStatus status = decoder.decode_frame(received, mask, decoded, ws);
+        if(status == DECODE_OK || status == DECODE_CORRECTED) pack_frame(decoded, 0, record);
+        else pack_frame(received, mask | frame_failed_flag, record);
+        expected.append((const char*)record, frame_record_size);
+    }
+    std::string single = run_stream(input, 1, 512, true, 63, valid, errors);
+    CHECK(valid && single == expected && errors.empty());
+    for(int threads : {2, 4, 7}) {
+        for(size_t frames_per_chunk : {1, 3, 64}) {
+            CHECK(run_stream(input, threads, frames_per_chunk, true, 63, valid, errors) == single);
+            CHECK(valid && errors.empty());
+        }
+    }
+    std::string truncated = input + std::string(20, '\x15');
+    CHECK(run_stream(truncated, 4, 3, true, 63, valid, errors) == single);
+    CHECK(valid && errors.find("incomplete record of 20 bytes") != std::string::npos);
+    // A header alone is an empty stream
+    CHECK(run_stream(input.substr(0, frame_header_size), 4, 3, true, 63, valid, errors) == input.substr(0, frame_header_size));
+    CHECK(valid);
+
+    // A bad or missing header writes nothing
+    CHECK(run_stream("garbage!" + input.substr(frame_header_size), 4, 3, true, 63, valid, errors).empty());
+    CHECK(!valid && errors.find("not a RS(63,42) frame stream") != std::string::npos);
+    CHECK(run_stream("RS6", 4, 3, true, 63, valid, errors).empty() && !valid);
+    CHECK(run_stream("", 1, 3, true, 63, valid, errors).empty() && !valid);
+    // An empty text stream is valid and gives no output
+    CHECK(run_stream("", 4, 3, false, 63, valid, errors).empty() && valid && errors.empty());
+    return test_result("pipeline");
+}
@@ -0,0 +1,69 @@
+// Shortened RS(63-s, 42-s): encodeShortened, BatchEncoder and RSCodec give the same codeword,
+// decode_shortened round trips within the radius, and it agrees with RSCodec and with
+// decode_frame on the zero-padded full frame
+#include "test_common.h"
+
+template<int S>
+static void run(std::mt19937& gen, ReedSolomonDecoder& decoder) {
+    using Codec = RSCodec<GF64Field, 63 - S, 42 - S, 1>;
+    const int length = 63 - S, message_length = 42 - S;
+    ReedSolomonEncoder encoder;
+    DecoderWorkspace ws;
+    for(int trial = 0; trial < 3000; trial++) {
+        uint8_t message[42], codeword[64] = {0}, batch[64] = {0}, codec[64] = {0};
+        for(int i = 0; i < message_length; i++) message[i] = gen() & 63;
+        encoder.encodeShortened(message, message_length, codeword);
+        BatchEncoder::instance().encode(message, batch, message_length);
+        Codec::encode(message, codec);
+        CHECK(memcmp(codeword, batch, length) == 0 && memcmp(codeword, codec, length) == 0);
+        CHECK(memcmp(codeword, message, message_length) == 0);
+
+        // Within the radius on even trials, anything up to 13 errors and 23 erasures on odd ones
+        int erasures = gen() % (trial % 2 ? 24 : 22);
+        int errors = trial % 2 ? gen() % 14 : gen() % ((21 - erasures) / 2 + 1);
+        erasures = std::min(erasures, length);
+        errors = std::min(errors, length - erasures);
+        uint8_t received[64], decoded[64], reference[64];
+        uint64_t mask = corrupt(gen, codeword, errors, erasures, received, length);
+        DecodeStatus status = decoder.decode_shortened(received, length, mask, decoded, ws);
+        if(trial % 2 == 0) CHECK((status == DECODE_OK || status == DECODE_CORRECTED) && memcmp(decoded, codeword, length) == 0);
+        CHECK(Codec::decode(received, mask, reference) == status && memcmp(decoded, reference, length) == 0);
+
+        // The full frame: message at 0~message_length-1, zeros, parity at 42~62
+        uint8_t full[64] = {0}, full_decoded[64];
+        memcpy(full, received, message_length);
+        memcpy(full + 42, received + message_length, 21);
+        uint64_t full_mask = (mask & ((1ULL << message_length) - 1)) | ((mask >> message_length) << 42);
+        DecodeStatus full_status = decoder.decode_frame(full, full_mask, full_decoded, ws);
+        bool zeros_kept = true;
+        for(int i = message_length; i < 42; i++) zeros_kept &= full_decoded[i] == 0;
+        if(full_status == DECODE_CORRECTED && !zeros_kept) CHECK(status == DECODE_UNCORRECTABLE);
+        else {
+            CHECK(status == full_status);
+            CHECK(memcmp(decoded, full_decoded, message_length) == 0 && memcmp(decoded + message_length, full_decoded + 42, 21) == 0);
+        }
+    }
+}
+
+int main() {
+    std::mt19937 gen(21);
+    for(KeyEquationSolver solver : {KEY_EQUATION_EUCLIDEAN, KEY_EQUATION_BERLEKAMP_MASSEY}) {
+        ReedSolomonDecoder decoder(solver);
+        run<0>(gen, decoder);
+        run<1>(gen, decoder);
+        run<7>(gen, decoder);
+        run<20>(gen, decoder);
+        run<33>(gen, decoder);
+        run<41>(gen, decoder);
+    }
+    // Lengths outside 22~63 are malformed and leave the output untouched
+    ReedSolomonDecoder decoder;
+    DecoderWorkspace ws;
+    uint8_t zero[64] = {0}, decoded[64];
+    for(int length : {-1, 0, 21, 64, 100}) {
+        memset(decoded, 0xAA, 64);
+        CHECK(decoder.decode_shortened(zero, length, 0, decoded, ws) == DECODE_MALFORMED && decoded[0] == 0xAA);
+    }
+    CHECK(decoder.decode_shortened(zero, 22, 0, decoded, ws) == DECODE_OK);
+    return test_result("shortened");
+}
@@ -0,0 +1,72 @@
+// SyndromeTableEngine and the split-nibble SyndromeEngine against the direct sums
+// S_j = sum(r_i * a^(i*j)), j = 1~21: every kernel, add() and compute_shortened()
+#include "test_common.h"
+
+// Direct syndromes in the engine layout (32 bytes, entries 21~31 zero)
+static void direct_syndromes(const uint8_t* received, uint8_t* syndromes) {
+    for(int j = 0; j < 32; j++) syndromes[j] = 0;
+    for(int j = 1; j <= 21; j++) {
+        for(int i = 0; i < 63; i++) syndromes[j - 1] ^= mul_table[received[i]][pow_table[(i * j) % 63]];
+    }
+}
+
+int main() {
+    std::mt19937 gen(17);
+    const SyndromeTableEngine& table = SyndromeTableEngine::instance();
+    SyndromeEngine nibble;
+    for(int trial = 0; trial < 5000; trial++) {
+        alignas(32) uint8_t received[64], expected[32], syndromes[32];
+        for(int i = 0; i < 63; i++) received[i] = trial % 10 == 0 ? (gen() % 8 == 0) * (gen() & 63) : gen() & 63;
+        received[63] = 0;
+        direct_syndromes(received, expected);
+
+        memset(syndromes, 0xFF, 32);
+        table.compute(received, syndromes);
+        CHECK(memcmp(syndromes, expected, 32) == 0);
+        memset(syndromes, 0xFF, 32);
+        table.compute_scalar(received, syndromes);
+        CHECK(memcmp(syndromes, expected, 32) == 0);
+#if defined(__SSE2__)
+        table.compute_sse2(received, syndromes);
+        CHECK(memcmp(syndromes, expected, 32) == 0);
+#endif
+#if defined(__AVX2__)
+        table.compute_avx2(received, syndromes);
+        CHECK(memcmp(syndromes, expected, 32) == 0);
+#endif
+        nibble.compute(received, syndromes);
+        CHECK(memcmp(syndromes, expected, 21) == 0);
+        nibble.compute_scalar(received, syndromes);
+        CHECK(memcmp(syndromes, expected, 21) == 0);
+
+        // add() replaces a symbol: adding old ^ new gives the syndromes of the new word
+        table.compute(received, syndromes);
+        for(int change = 0; change < 4; change++) {
+            int position = gen() % 63;
+            uint8_t value = gen() & 63;
+            table.add(position, received[position] ^ value, syndromes);
+            received[position] = value;
+        }
+        direct_syndromes(received, expected);
+        CHECK(memcmp(syndromes, expected, 32) == 0);
+
+        // A shortened frame has the syndromes of the full frame with zeros at message_length~41
+        int message_length = 1 + gen() % 42;
+        alignas(32) uint8_t full[64] = {0};
+        memcpy(full, received, message_length);
+        memcpy(full + 42, received + message_length, 21);
+        direct_syndromes(full, expected);
+        memset(syndromes, 0xFF, 32);
+        table.compute_shortened(received, message_length, syndromes);
+        CHECK(memcmp(syndromes, expected, 32) == 0);
+    }
+    // Codewords have zero syndromes
+    for(int trial = 0; trial < 100; trial++) {
+        uint8_t codeword[64];
+        random_codeword(gen, codeword);
+        CHECK(is_codeword(codeword));
+        codeword[gen() % 63] ^= 1 + gen() % 63;
+        CHECK(!is_codeword(codeword));
+    }
+    return test_result("syndromes");
+}
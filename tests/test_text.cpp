@@ -0,0 +1,118 @@
+// rs_text.h: well-formed frames, every error case with its line, frame and symbol index,
+// resynchronization after a bad token, and TextFrameReader across block boundaries
+#include <string>
+#include <vector>
+#include "rs_text.h"
+#include "test_common.h"
+
+// Text of one frame: values[i] < 0 is an erasure
+static std::string frame_text(const int* values, const char* separator = " ") {
+    std::string text;
+    for(int i = 0; i < 63; i++) {
+        if(i > 0) text += separator;
+        text += values[i] < 0 ? std::string("*") : std::to_string(values[i]);
+    }
+    return text + "\n";
+}
+
+// Parse the first frame of text
+static TextParseError parse(const std::string& text, uint8_t* symbols, uint64_t& mask, size_t& line, int length = 63) {
+    TextParseError error;
+    error.frame = 0;
+    line = 1;
+    parse_text_frame(text.data(), text.data() + text.size(), symbols, mask, line, error, length);
+    return error;
+}
+
+int main() {
+    std::mt19937 gen(12);
+    int values[63];
+    for(int i = 0; i < 63; i++) values[i] = i % 7 == 3 ? -1 : gen() % 64;
+    uint8_t symbols[64];
+    uint64_t mask;
+    size_t line;
+
+    // A well-formed frame spread over lines, with tabs
+    std::string text = frame_text(values, " \t\n");
+    TextParseError error = parse(text, symbols, mask, line);
+    CHECK(error.reason == nullptr);
+    CHECK(line == 63);
+    for(int i = 0; i < 63; i++) {
+        CHECK(((mask >> i) & 1) == (values[i] < 0));
+        CHECK(symbols[i] == (values[i] < 0 ? 0 : values[i]));
+    }
+
+    // Bad tokens: the first problem of the frame is reported, on the line it is on
+    struct Case { const char* token; const char* reason; } cases[] = {
+        {"64", "symbol out of range 0~63"}, {"99", "symbol out of range 0~63"}, {"123", "symbol out of range 0~63"},
+        {"007", "symbol out of range 0~63"}, {"1a", "invalid token"}, {"**", "invalid token"}, {"*1", "invalid token"},
+        {"a", "unexpected character"}, {"-1", "unexpected character"}, {"+5", "unexpected character"}
+    };
+    for(const Case& c : cases) {
+        int position = gen() % 63;
+        std::string bad;
+        for(int i = 0; i < 63; i++) {
+            bad += i == position ? std::string(c.token) : std::to_string(values[i] < 0 ? 0 : values[i]);
+            bad += i % 10 == 9 ? "\n" : " ";
+        }
+        // A second bad token later in the frame is not the one reported
+        if(position < 62) bad.replace(bad.rfind(' ', bad.size() - 2) + 1, 0, "x");
+        error = parse(bad, symbols, mask, line);
+        CHECK(error.reason != nullptr && std::string(error.reason) == c.reason);
+        CHECK(error.symbol == position);
+        CHECK(error.line == (size_t)position / 10 + 1);
+    }
+
+    // An incomplete frame is reported on the line it starts, the missing symbols are 0
+    std::string incomplete = "\n\n1 2 3\n4 5";
+    error = parse(incomplete, symbols, mask, line);
+    CHECK(error.reason != nullptr && std::string(error.reason) == "incomplete frame at the end of the input");
+    CHECK(error.line == 3 && error.symbol == 5);
+    CHECK(symbols[4] == 5 && symbols[5] == 0 && symbols[62] == 0);
+    error = parse("", symbols, mask, line);
+    CHECK(error.reason != nullptr && error.symbol == 0);
+
+    // Shortened frames have length symbols
+    error = parse("1 2 3 * 5", symbols, mask, line, 5);
+    CHECK(error.reason == nullptr && mask == 8 && symbols[4] == 5);
+
+    // TextFrameReader: a bad frame does not shift the next ones, frames cross the 64-byte
+    // blocks (which grow for frames longer than a block), and errors carry the frame index
+    std::string stream;
+    std::vector<int> expected_first;
+    for(int f = 0; f < 50; f++) {
+        for(int i = 0; i < 63; i++) values[i] = i % 5 == f % 5 ? -1 : gen() % 64;
+        std::string frame = frame_text(values, f % 3 ? " " : "  \n");
+        if(f % 10 == 4) frame.replace(frame.find(' '), 1, "z ");
+        stream += frame;
+        expected_first.push_back(values[0]);
+    }
+    stream += "1 2 3\n";
+    FILE* file = tmpfile();
+    CHECK(file != nullptr);
+    if(file == nullptr) return test_result("text");
+    fwrite(stream.data(), 1, stream.size(), file);
+    fflush(file);
+    rewind(file);
+    TextFrameReader reader(file, 64);
+    uint8_t frames[8 * 64];
+    uint64_t masks[8];
+    TextParseError errors[8];
+    size_t total = 0, got;
+    while((got = reader.read(frames, masks, errors, 8)) > 0) {
+        for(size_t f = 0; f < got; f++, total++) {
+            CHECK(errors[f].frame == total);
+            if(total == 50) {
+                CHECK(errors[f].reason != nullptr && std::string(errors[f].reason) == "incomplete frame at the end of the input");
+                continue;
+            }
+            CHECK((errors[f].reason != nullptr) == (total % 10 == 4));
+            if(total % 10 == 4) CHECK(errors[f].symbol == 0 && std::string(errors[f].reason) == "invalid token");
+            else CHECK(frames[f * 64] == (expected_first[total] < 0 ? 0 : expected_first[total]));
+            for(int i = 0; i < 63; i++) CHECK(((masks[f] >> i) & 1) == (uint64_t)(i % 5 == (int)(total % 5)));
+        }
+    }
+    CHECK(total == 51);
+    fclose(file);
+    return test_result("text");
+}
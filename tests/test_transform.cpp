@@ -0,0 +1,59 @@
+// GF64Transform against the direct 63-point sums, and the transform root search: frames whose
+// locator has degree >= 8 (errors plus erasures) decode like RS63_42, which uses a Chien search
+#include "gf64_fft.h"
+#include "test_common.h"
+
+using RS43_22 = RSCodec<GF64Field, 43, 22, 1>;
+
+int main() {
+    std::mt19937 gen(24);
+    for(int trial = 0; trial < 3000; trial++) {
+        uint8_t x[64] = {0}, X[63], values[63];
+        for(int i = 0; i < 63; i++) x[i] = gen() & 63;
+        GF64Transform::forward(x, X);
+        for(int k = 0; k < 63; k++) {
+            uint8_t sum = 0;
+            for(int i = 0; i < 63; i++) sum ^= mul_table[x[i]][pow_table[(i * k) % 63]];
+            CHECK(sum == X[k]);
+        }
+        // evaluate() of a polynomial of degree d is the transform of its coefficients
+        int degree = gen() % 63;
+        uint8_t truncated[63] = {0};
+        memcpy(truncated, x, degree + 1);
+        GF64Transform::evaluate(x, degree, values);
+        GF64Transform::forward(truncated, X);
+        CHECK(memcmp(values, X, 63) == 0);
+        // syndromes() is the table engine's layout
+        alignas(32) uint8_t syndromes[32], expected[32];
+        GF64Transform::syndromes(x, syndromes);
+        SyndromeTableEngine::instance().compute(x, expected);
+        CHECK(memcmp(syndromes, expected, 32) == 0);
+    }
+
+    ReedSolomonDecoder decoder;
+    DecoderWorkspace ws;
+    for(int degree = 8; degree <= 23; degree++) {
+        for(int trial = 0; trial < 300; trial++) {
+            uint8_t codeword[64], received[64], decoded[64], reference[64];
+            random_codeword(gen, codeword);
+            // At least one error, so the key equation and the root search run
+            int errors = 1 + gen() % degree, erasures = degree - errors;
+            uint64_t mask = corrupt(gen, codeword, errors, erasures, received);
+            DecodeStatus status = decoder.decode_frame(received, mask, decoded, ws);
+            if(2 * errors + erasures <= 21) CHECK(status == DECODE_CORRECTED && memcmp(decoded, codeword, 63) == 0);
+            CHECK(RS63_42::decode(received, mask, reference) == status && memcmp(decoded, reference, 63) == 0);
+
+            // The same in a shortened RS(43,22) frame (the search skips the implied zeros)
+            uint8_t message[22], shortened[64] = {0};
+            for(auto& m : message) m = gen() & 63;
+            BatchEncoder::instance().encode(message, shortened, 22);
+            errors = std::min(errors, 43 - erasures);
+            mask = corrupt(gen, shortened, errors, erasures, received, 43);
+            status = decoder.decode_shortened(received, 43, mask, decoded, ws);
+            if(2 * errors + erasures <= 21) CHECK(status == DECODE_CORRECTED && memcmp(decoded, shortened, 43) == 0);
+            CHECK(RS43_22::decode(received, mask, reference) == status);
+            CHECK(memcmp(decoded, reference, 43) == 0);
+        }
+    }
+    return test_result("transform");
+}
@@ -0,0 +1,93 @@
+// rs_wire.h: the record bit layout, pack/unpack round trips, the header check, and
+// FrameWriter/FrameReader across buffer boundaries and a truncated stream
+#include <vector>
+#include "rs_wire.h"
+#include "test_common.h"
+
+int main() {
+    std::mt19937_64 gen(11);
+
+    // Symbol i is bits 6i ~ 6i+5 of the little-endian record, bits 378 ~ 383 are 0,
+    // and the mask (bit 63 included) follows the 48 symbol bytes
+    for(int trial = 0; trial < 2000; trial++) {
+        uint8_t symbols[64], unpacked[64], record[frame_record_size];
+        for(int i = 0; i < 63; i++) symbols[i] = gen() & 63;
+        symbols[63] = gen();
+        uint64_t mask = gen(), unpacked_mask;
+        if(trial % 2) mask |= frame_failed_flag;
+        pack_frame(symbols, mask, record);
+        for(int i = 0; i < 63; i++) {
+            int value = 0;
+            for(int b = 0; b < 6; b++) value |= ((record[(6 * i + b) / 8] >> ((6 * i + b) % 8)) & 1) << b;
+            CHECK(value == symbols[i]);
+        }
+        CHECK((record[47] >> 2) == 0);
+        unpack_frame(record, unpacked, unpacked_mask);
+        CHECK(memcmp(unpacked, symbols, 63) == 0);
+        CHECK(unpacked_mask == mask);
+    }
+
+    // Symbols are packed to 6 bits
+    uint8_t wide[64], narrow[64], record[frame_record_size];
+    uint64_t mask;
+    for(int i = 0; i < 64; i++) wide[i] = 0xC0 | i;
+    pack_frame(wide, 0, record);
+    unpack_frame(record, narrow, mask);
+    for(int i = 0; i < 63; i++) CHECK(narrow[i] == i);
+
+    // Header
+    uint8_t header[frame_header_size];
+    make_frame_header(header);
+    CHECK(memcmp(header, "RS63", 4) == 0 && header[4] == frame_format_version && header[5] == 63 && header[6] == 42);
+    CHECK(check_frame_header(header));
+    for(int i = 0; i < frame_header_size; i++) {
+        header[i] ^= 1;
+        CHECK(!check_frame_header(header));
+        header[i] ^= 1;
+    }
+
+    // Writer and reader through a file, with buffers much smaller than the stream
+    const size_t count = 1000, stride = 70;
+    std::vector<uint8_t> frames(count * stride), read_back(count * stride);
+    std::vector<uint64_t> masks(count), read_masks(count);
+    for(size_t f = 0; f < count; f++) {
+        for(int i = 0; i < 63; i++) frames[f * stride + i] = gen() & 63;
+        masks[f] = gen() & ((1ULL << 63) - 1);
+        if(f % 10 == 0) masks[f] |= frame_failed_flag;
+    }
+    FILE* file = tmpfile();
+    CHECK(file != nullptr);
+    if(file == nullptr) return test_result("wire");
+    {
+        FrameWriter writer(file, 7);
+        writer.write_header();
+        writer.write(frames.data(), masks.data(), count - 1, stride);
+        writer.write(&frames[(count - 1) * stride], masks[count - 1]);
+    }
+    // A partial record at the end is not a frame
+    fwrite(record, 1, frame_record_size - 1, file);
+    fflush(file);
+    rewind(file);
+    FrameReader reader(file, 13);
+    CHECK(reader.read_header());
+    size_t total = 0, got;
+    while((got = reader.read(&read_back[total * stride], &read_masks[total], 300, stride)) > 0) total += got;
+    CHECK(total == count);
+    for(size_t f = 0; f < count; f++) {
+        CHECK(memcmp(&read_back[f * stride], &frames[f * stride], 63) == 0);
+        CHECK(read_masks[f] == masks[f]);
+    }
+    uint8_t one[64];
+    uint64_t one_mask;
+    CHECK(!reader.read(one, one_mask));
+
+    // A stream without the header is rejected
+    rewind(file);
+    fputc('X', file);
+    fflush(file);
+    rewind(file);
+    FrameReader bad(file);
+    CHECK(!bad.read_header());
+    fclose(file);
+    return test_result("wire");
+}